@@ -0,0 +1,333 @@
+#include "aggregator.h"
+#include "string.h"
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Entrada en una cola monótona: se descartan los valores que ya no pueden ser extremo
+ */
+static void Deque_Push(struct AggDeque *deque, uint32_t seq, float value, bool is_min)
+{
+    while (deque->count > 0)
+    {
+        uint16_t back = (deque->head + deque->count - 1) % AGG_MAX_WINDOW;
+        float back_value = deque->items[back].value;
+        if (is_min ? back_value < value : back_value > value)
+        {
+            break;
+        }
+        deque->count--;
+    }
+
+    uint16_t tail = (deque->head + deque->count) % AGG_MAX_WINDOW;
+    deque->items[tail].seq = seq;
+    deque->items[tail].value = value;
+    deque->count++;
+}
+
+/**
+ * @brief Salida por el frente de las muestras anteriores a first_seq
+ */
+static void Deque_Expire(struct AggDeque *deque, uint32_t first_seq)
+{
+    // Resta sin signo: correcta aunque el contador de muestras dé la vuelta
+    while (deque->count > 0 && (int32_t)(deque->items[deque->head].seq - first_seq) < 0)
+    {
+        deque->head = (deque->head + 1) % AGG_MAX_WINDOW;
+        deque->count--;
+    }
+}
+
+/**
+ * @brief Reinicio de una magnitud al empezar una ventana
+ */
+static void Reset_Channel(struct AggChannel *channel)
+{
+    channel->min_deque.head = 0;
+    channel->min_deque.count = 0;
+    channel->max_deque.head = 0;
+    channel->max_deque.count = 0;
+    channel->offset = 0.0f;
+    channel->mean = 0.0f;
+    channel->m2 = 0.0f;
+}
+
+/**
+ * @brief Muestra en una ventana fija: Welford y extremos directos
+ */
+static void Add_Tumbling(struct AggChannel *channel, float value, uint16_t count)
+{
+    if (count == 1)
+    {
+        channel->offset = value;
+    }
+
+    float relative = value - channel->offset;
+    float delta = relative - channel->mean;
+    channel->mean += delta / count;
+    channel->m2 += delta * (relative - channel->mean);
+
+    if (count == 1 || value < channel->min)
+    {
+        channel->min = value;
+    }
+    if (count == 1 || value > channel->max)
+    {
+        channel->max = value;
+    }
+}
+
+/**
+ * @brief Muestra en la ventana deslizante
+ *
+ * @param count : muestras en la ventana antes de esta
+ */
+static void Add_Sliding(struct AggChannel *channel, float value, uint32_t seq, uint16_t pos, uint16_t count,
+                        uint16_t window)
+{
+    if (count == 0)
+    {
+        channel->offset = value;
+    }
+
+    // Welford sobre valores relativos; las colas guardan el valor original, exacto
+    float relative = value - channel->offset;
+    if (count < window)
+    {
+        float delta = relative - channel->mean;
+        channel->mean += delta / (count + 1);
+        channel->m2 += delta * (relative - channel->mean);
+    }
+    else
+    {
+        // Sustitución de la muestra más antigua en una sola actualización de Welford
+        float old_value = channel->values[pos];
+        float old_mean = channel->mean;
+        float delta = relative - old_value;
+        channel->mean += delta / window;
+        channel->m2 += delta * (relative - channel->mean + old_value - old_mean);
+        if (channel->m2 < 0.0f)
+        {
+            channel->m2 = 0.0f;
+        }
+    }
+    channel->values[pos] = relative;
+
+    // Primero sale la muestra sustituida, así la cola nunca pasa de `window` entradas
+    Deque_Expire(&channel->min_deque, seq + 1 - window);
+    Deque_Expire(&channel->max_deque, seq + 1 - window);
+    Deque_Push(&channel->min_deque, seq, value, true);
+    Deque_Push(&channel->max_deque, seq, value, false);
+}
+
+/**
+ * @brief Recálculo exacto de media y varianza desde el histórico, con la referencia en la media
+ */
+static void Resync_Channel(struct AggChannel *channel, uint16_t window)
+{
+    float mean = 0.0f;
+    float m2 = 0.0f;
+
+    for (uint16_t i = 0; i < window; i++)
+    {
+        mean += channel->values[i];
+    }
+    mean /= window;
+
+    // Nueva referencia: los valores guardados vuelven a quedar cerca de cero si la magnitud deriva
+    channel->offset += mean;
+    for (uint16_t i = 0; i < window; i++)
+    {
+        channel->values[i] -= mean;
+        m2 += channel->values[i] * channel->values[i];
+    }
+    channel->mean = 0.0f;
+    channel->m2 = m2;
+}
+
+/**
+ * @brief Resumen de una magnitud
+ */
+static void Fill_Stats(const struct Aggregator *agg, const struct AggChannel *channel, struct AggStats *stats)
+{
+    if (agg->config.type == AGG_SLIDING)
+    {
+        stats->min = channel->min_deque.items[channel->min_deque.head].value;
+        stats->max = channel->max_deque.items[channel->max_deque.head].value;
+    }
+    else
+    {
+        stats->min = channel->min;
+        stats->max = channel->max;
+    }
+    stats->mean = channel->offset + channel->mean;
+    stats->variance = agg->count > 1 ? channel->m2 / (agg->count - 1) : 0.0f;
+}
+
+/**
+ * @brief Resumen de la ventana actual
+ */
+static void Fill_Summary(const struct Aggregator *agg, struct AggSummary *summary)
+{
+    Fill_Stats(agg, &agg->press, &summary->press);
+    Fill_Stats(agg, &agg->temp, &summary->temp);
+    summary->count = agg->count;
+    summary->last_us = agg->last_us;
+    if (agg->config.type == AGG_SLIDING && agg->count == agg->config.window)
+    {
+        // Con la ventana llena, la posición siguiente guarda la muestra más antigua
+        summary->first_us = agg->times_us[agg->pos];
+    }
+    else
+    {
+        summary->first_us = agg->first_us;
+    }
+}
+
+/**
+ * @brief Entrega de un resumen
+ */
+static void Emit(struct Aggregator *agg)
+{
+    struct AggSummary summary;
+
+    Fill_Summary(agg, &summary);
+    agg->emitted++;
+    if (agg->config.output != NULL)
+    {
+        agg->config.output(&summary, agg->config.user);
+    }
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Inicialización de un agregador
+ *
+ * @param agg : contexto
+ * @param config : configuración
+ * @return AggEnum_t error/success
+ */
+AggEnum_t Init_Aggregator(struct Aggregator *agg, const struct AggConfig *config)
+{
+    if (config->window == 0 || config->window > AGG_MAX_WINDOW)
+    {
+        return AGG_FAILED;
+    }
+
+    memset(agg, 0, sizeof(*agg));
+    agg->config = *config;
+    if (agg->config.hop == 0 || agg->config.hop > agg->config.window)
+    {
+        agg->config.hop = agg->config.window;
+    }
+    // El primer resumen de la deslizante sale en cuanto se llena la ventana
+    agg->since_emit = agg->config.hop - 1;
+    return AGG_SUCCESS;
+}
+
+/**
+ * @brief Entrada de una muestra compensada
+ *
+ * @param agg : contexto
+ * @param press : presión (Pa)
+ * @param temp : temperatura (ºC)
+ * @param time_us : instante de la muestra
+ * @return true si se ha entregado un resumen
+ */
+bool Aggregator_Add(struct Aggregator *agg, float press, float temp, uint32_t time_us)
+{
+    uint16_t window = agg->config.window;
+
+    if (agg->count == 0)
+    {
+        agg->first_us = time_us;
+    }
+    agg->last_us = time_us;
+
+    if (agg->config.type == AGG_TUMBLING)
+    {
+        agg->count++;
+        agg->seq++;
+        Add_Tumbling(&agg->press, press, agg->count);
+        Add_Tumbling(&agg->temp, temp, agg->count);
+        if (agg->count < window)
+        {
+            return false;
+        }
+        Emit(agg);
+        agg->count = 0;
+        Reset_Channel(&agg->press);
+        Reset_Channel(&agg->temp);
+        return true;
+    }
+
+    Add_Sliding(&agg->press, press, agg->seq, agg->pos, agg->count, window);
+    Add_Sliding(&agg->temp, temp, agg->seq, agg->pos, agg->count, window);
+    agg->times_us[agg->pos] = time_us;
+    agg->seq++;
+    agg->pos = (agg->pos + 1 == window) ? 0 : agg->pos + 1;
+    if (agg->count < window)
+    {
+        agg->count++;
+    }
+    if (agg->count < window)
+    {
+        return false;
+    }
+
+    if (agg->seq % ((uint32_t)AGG_RESYNC_WINDOWS * window) == 0)
+    {
+        Resync_Channel(&agg->press, window);
+        Resync_Channel(&agg->temp, window);
+    }
+    if (++agg->since_emit < agg->config.hop)
+    {
+        return false;
+    }
+    agg->since_emit = 0;
+    Emit(agg);
+    return true;
+}
+
+/**
+ * @brief Entrada de un lote de muestras, p. ej. una descarga de la FIFO ya compensada
+ *
+ * @param agg : contexto
+ * @param press : presiones (Pa)
+ * @param temp : temperaturas (ºC)
+ * @param count : número de muestras
+ * @param time_us : instante del lote, común a todas sus muestras
+ * @return uint16_t resúmenes entregados
+ */
+uint16_t Aggregator_Add_Batch(struct Aggregator *agg, const float *press, const float *temp, uint16_t count,
+                              uint32_t time_us)
+{
+    uint16_t emitted = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (Aggregator_Add(agg, press[i], temp[i], time_us))
+        {
+            emitted++;
+        }
+    }
+    return emitted;
+}
+
+/**
+ * @brief Resumen de las muestras de la ventana actual, sin entregarlo ni reiniciarla
+ *
+ * @param agg : contexto
+ * @param summary : parámetro de salida
+ * @return AggEnum_t error si la ventana está vacía
+ */
+AggEnum_t Aggregator_Peek(const struct Aggregator *agg, struct AggSummary *summary)
+{
+    if (agg->count == 0)
+    {
+        return AGG_FAILED;
+    }
+    Fill_Summary(agg, summary);
+    return AGG_SUCCESS;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/*
+ * Agregador de estadísticas por ventanas: en lugar de cada muestra, sólo se entregan
+ * resúmenes con mínimo, máximo, media y varianza de presión y temperatura.
+ *
+ * Coste O(1) por muestra: media y varianza con Welford (en la ventana deslizante, con
+ * la actualización de sustitución de la muestra más antigua), mínimo y máximo con
+ * colas monótonas. El contexto lo aporta quien lo usa, uno por sensor.
+ */
+
+// Ventana máxima en muestras (tamaño del histórico de la ventana deslizante)
+#ifndef AGG_MAX_WINDOW
+#define AGG_MAX_WINDOW      128
+#endif
+
+// La ventana deslizante recalcula media y varianza desde el histórico cada tantas
+// vueltas, para que el error de redondeo de las sustituciones no se acumule
+#define AGG_RESYNC_WINDOWS  64
+
+typedef enum
+{
+    AGG_FAILED = 0,
+    AGG_SUCCESS
+} AggEnum_t;
+
+typedef enum
+{
+    AGG_TUMBLING = 0, // Ventanas consecutivas sin solape, un resumen por ventana
+    AGG_SLIDING       // Últimas `window` muestras, un resumen cada `hop` muestras
+} AggWindow_t;
+
+/*! Resumen de una magnitud en la ventana */
+struct AggStats
+{
+    float min;
+    float max;
+    float mean;
+    float variance; // Varianza muestral (n - 1)
+};
+
+/*! Resumen de una ventana */
+struct AggSummary
+{
+    struct AggStats press;
+    struct AggStats temp;
+    uint16_t count;
+    uint32_t first_us; // Instante de la primera muestra de la ventana
+    uint32_t last_us;  // Instante de la última muestra de la ventana
+};
+
+typedef void (*AggOutput_t)(const struct AggSummary *summary, void *user);
+
+/*! Configuración de un agregador */
+struct AggConfig
+{
+    AggWindow_t type;
+    uint16_t window; // Muestras por ventana, hasta AGG_MAX_WINDOW
+    uint16_t hop;    // Sólo deslizante: muestras entre resúmenes (0 = window)
+    AggOutput_t output;
+    void *user;
+};
+
+/*! Entrada de una cola monótona */
+struct AggDequeItem
+{
+    uint32_t seq; // Número de muestra, para saber cuándo sale de la ventana
+    float value;
+};
+
+/*! Cola monótona circular: el frente es el mínimo (o máximo) de la ventana */
+struct AggDeque
+{
+    struct AggDequeItem items[AGG_MAX_WINDOW];
+    uint16_t head;
+    uint16_t count;
+};
+
+/*! Estado de una magnitud */
+struct AggChannel
+{
+    float values[AGG_MAX_WINDOW]; // Histórico de la ventana deslizante
+    struct AggDeque min_deque;    // Valores crecientes
+    struct AggDeque max_deque;    // Valores decrecientes
+    float offset; // Referencia de los valores guardados: con 1e5 Pa el float no tiene resolución para la varianza
+    float mean;   // Respecto a offset
+    float m2;
+    float min; // Ventana fija: no hace falta cola
+    float max;
+};
+
+/*! Contexto de un agregador */
+struct Aggregator
+{
+    struct AggConfig config;
+    struct AggChannel press;
+    struct AggChannel temp;
+    uint32_t seq;     // Muestras recibidas
+    uint16_t count;   // Muestras en la ventana actual
+    uint16_t pos;     // Siguiente posición del histórico
+    uint16_t since_emit;
+    uint32_t times_us[AGG_MAX_WINDOW];
+    uint32_t first_us;
+    uint32_t last_us;
+    uint32_t emitted; // Resúmenes entregados
+};
+
+/**
+ * @brief Inicialización de un agregador
+ *
+ * @param agg : contexto
+ * @param config : configuración
+ * @return AggEnum_t error/success
+ */
+AggEnum_t Init_Aggregator(struct Aggregator *agg, const struct AggConfig *config);
+
+/**
+ * @brief Entrada de una muestra compensada
+ *
+ * @param agg : contexto
+ * @param press : presión (Pa)
+ * @param temp : temperatura (ºC)
+ * @param time_us : instante de la muestra
+ * @return true si se ha entregado un resumen
+ */
+bool Aggregator_Add(struct Aggregator *agg, float press, float temp, uint32_t time_us);
+
+/**
+ * @brief Entrada de un lote de muestras, p. ej. una descarga de la FIFO ya compensada
+ *
+ * @param agg : contexto
+ * @param press : presiones (Pa)
+ * @param temp : temperaturas (ºC)
+ * @param count : número de muestras
+ * @param time_us : instante del lote, común a todas sus muestras
+ * @return uint16_t resúmenes entregados
+ */
+uint16_t Aggregator_Add_Batch(struct Aggregator *agg, const float *press, const float *temp, uint16_t count,
+                              uint32_t time_us);
+
+/**
+ * @brief Resumen de las muestras de la ventana actual, sin entregarlo ni reiniciarla
+ *
+ * @param agg : contexto
+ * @param summary : parámetro de salida
+ * @return AggEnum_t error si la ventana está vacía
+ */
+AggEnum_t Aggregator_Peek(const struct Aggregator *agg, struct AggSummary *summary);
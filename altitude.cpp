@@ -0,0 +1,168 @@
+#include "altitude.h"
+#include "math.h"
+
+static float altitude_table[ALTITUDE_TABLE_SIZE];
+static bool table_ready = false;
+
+static const float ratio_step = (ALTITUDE_RATIO_MAX - ALTITUDE_RATIO_MIN) / (ALTITUDE_TABLE_SIZE - 1);
+static const float inv_ratio_step = (ALTITUDE_TABLE_SIZE - 1) / (ALTITUDE_RATIO_MAX - ALTITUDE_RATIO_MIN);
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/*!
+ * @brief Relleno de la tabla, una única vez
+ */
+static void Build_Altitude_Table()
+{
+    if (table_ready)
+    {
+        return;
+    }
+
+    for (uint16_t i = 0; i < ALTITUDE_TABLE_SIZE; i++)
+    {
+        float ratio = ALTITUDE_RATIO_MIN + i * ratio_step;
+        altitude_table[i] = ALTITUDE_SCALE_M * (1.0f - powf(ratio, ALTITUDE_EXPONENT));
+    }
+    table_ready = true;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Inicialización del estado y de la tabla compartida
+ *
+ * @param state : estado a inicializar
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @param ref_press_pa : presión en el punto de referencia (Pa)
+ * @param vspeed_alpha : suavizado de la velocidad vertical, entre 0 y 1
+ */
+void Init_Altitude(struct AltitudeState *state, float qnh_pa, float ref_press_pa, float vspeed_alpha)
+{
+    Build_Altitude_Table();
+
+    state->qnh_pa = qnh_pa;
+    state->ref_press_pa = ref_press_pa;
+    state->ref_alt = Get_Altitude(ref_press_pa, qnh_pa);
+    state->vspeed_alpha = vspeed_alpha;
+    state->last_press = 0.0f;
+    state->last_alt = 0.0f;
+    state->vspeed = 0.0f;
+    state->last_time_us = 0;
+    state->has_last = false;
+}
+
+/**
+ * @brief Cambio de QNH manteniendo el punto de referencia
+ *
+ * @param state : estado
+ * @param qnh_pa : nueva presión a nivel del mar (Pa)
+ */
+void Set_Altitude_QNH(struct AltitudeState *state, float qnh_pa)
+{
+    // Se recalculan la referencia y la última muestra para que ni la altura relativa
+    // ni la velocidad vertical salten con el cambio de QNH
+    state->qnh_pa = qnh_pa;
+    state->ref_alt = Get_Altitude(state->ref_press_pa, qnh_pa);
+    if (state->has_last)
+    {
+        state->last_alt = Get_Altitude(state->last_press, qnh_pa);
+    }
+}
+
+/**
+ * @brief Altitud por tabla
+ *
+ * @param press_pa : presión compensada (Pa)
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @return float altitud (m)
+ */
+float Get_Altitude(float press_pa, float qnh_pa)
+{
+    float ratio = press_pa / qnh_pa;
+    if (!table_ready || ratio < ALTITUDE_RATIO_MIN || ratio >= ALTITUDE_RATIO_MAX)
+    {
+        return Get_Altitude_Exact(press_pa, qnh_pa);
+    }
+
+    float pos = (ratio - ALTITUDE_RATIO_MIN) * inv_ratio_step;
+    uint16_t idx = (uint16_t)pos;
+    float frac = pos - idx;
+
+    return altitude_table[idx] + frac * (altitude_table[idx + 1] - altitude_table[idx]);
+}
+
+/**
+ * @brief Altitud por la fórmula exacta con powf, como referencia
+ *
+ * @param press_pa : presión compensada (Pa)
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @return float altitud (m)
+ */
+float Get_Altitude_Exact(float press_pa, float qnh_pa)
+{
+    return ALTITUDE_SCALE_M * (1.0f - powf(press_pa / qnh_pa, ALTITUDE_EXPONENT));
+}
+
+/**
+ * @brief Altitud, altura relativa y velocidad vertical de un lote de muestras
+ *
+ * @param state : estado, se actualiza con la última muestra
+ * @param press_pa : presiones compensadas (Pa)
+ * @param time_us : instante de cada muestra (us)
+ * @param out : parámetro de salida
+ * @param n : número de muestras
+ */
+void Get_Altitude_Batch(struct AltitudeState *state, const float *press_pa, const uint32_t *time_us,
+                        struct AltitudeSample *out, uint16_t n)
+{
+    // Una única división por lote: el índice se calcula con la inversa del QNH
+    float inv_qnh = 1.0f / state->qnh_pa;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        float ratio = press_pa[i] * inv_qnh;
+        float alt;
+
+        if (ratio >= ALTITUDE_RATIO_MIN && ratio < ALTITUDE_RATIO_MAX)
+        {
+            float pos = (ratio - ALTITUDE_RATIO_MIN) * inv_ratio_step;
+            uint16_t idx = (uint16_t)pos;
+            float frac = pos - idx;
+            alt = altitude_table[idx] + frac * (altitude_table[idx + 1] - altitude_table[idx]);
+        }
+        else
+        {
+            alt = Get_Altitude_Exact(press_pa[i], state->qnh_pa);
+        }
+
+        if (state->has_last)
+        {
+            uint32_t dt_us = time_us[i] - state->last_time_us;
+            if (dt_us > 0)
+            {
+                float speed = (alt - state->last_alt) * 1000000.0f / dt_us;
+                state->vspeed += state->vspeed_alpha * (speed - state->vspeed);
+            }
+        }
+
+        out[i].altitude = alt;
+        out[i].height = alt - state->ref_alt;
+        out[i].vspeed = state->vspeed;
+
+        state->last_press = press_pa[i];
+        state->last_alt = alt;
+        state->last_time_us = time_us[i];
+        state->has_last = true;
+    }
+}
+
+/**
+ * @brief Memoria estática de la tabla de altitud
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Altitude_Footprint()
+{
+    return sizeof(altitude_table) + sizeof(table_ready);
+}
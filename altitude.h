@@ -0,0 +1,95 @@
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+
+// Presión estándar a nivel del mar (Pa)
+#define ALTITUDE_STD_QNH_PA     101325.0f
+
+// Fórmula barométrica: h = 44330 * (1 - (p / p0) ^ (1 / 5.255))
+#define ALTITUDE_SCALE_M        44330.0f
+#define ALTITUDE_EXPONENT       0.190295f
+
+// Tabla de altitud frente a p / p0. Con 257 puntos e interpolación lineal el error
+// máximo frente a powf es de 0.2 m en todo el rango (300-1250 hPa con QNH de
+// 930-1200 hPa); fuera de él se usa la fórmula exacta.
+#define ALTITUDE_TABLE_SIZE     257
+#define ALTITUDE_RATIO_MIN      0.25f
+#define ALTITUDE_RATIO_MAX      1.35f
+
+/*! Estado del cálculo de altitud por lotes */
+struct AltitudeState
+{
+    float qnh_pa;        // Presión de referencia a nivel del mar
+    float ref_press_pa;  // Presión en el punto de referencia para la altura relativa
+    float ref_alt;       // Altitud del punto de referencia
+    float vspeed_alpha;  // Suavizado exponencial de la velocidad vertical (1 = sin filtro)
+    float last_press;
+    float last_alt;
+    float vspeed;
+    uint32_t last_time_us;
+    bool has_last;
+};
+
+/*! Magnitudes derivadas de una muestra de presión */
+struct AltitudeSample
+{
+    float altitude; // Altitud respecto al QNH (m)
+    float height;   // Altura sobre el punto de referencia (m)
+    float vspeed;   // Velocidad vertical (m/s)
+};
+
+/**
+ * @brief Inicialización del estado y de la tabla compartida
+ *
+ * @param state : estado a inicializar
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @param ref_press_pa : presión en el punto de referencia (Pa)
+ * @param vspeed_alpha : suavizado de la velocidad vertical, entre 0 y 1
+ */
+void Init_Altitude(struct AltitudeState *state, float qnh_pa, float ref_press_pa, float vspeed_alpha);
+
+/**
+ * @brief Cambio de QNH manteniendo el punto de referencia
+ *
+ * @param state : estado
+ * @param qnh_pa : nueva presión a nivel del mar (Pa)
+ */
+void Set_Altitude_QNH(struct AltitudeState *state, float qnh_pa);
+
+/**
+ * @brief Altitud por tabla
+ *
+ * @param press_pa : presión compensada (Pa)
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @return float altitud (m)
+ */
+float Get_Altitude(float press_pa, float qnh_pa);
+
+/**
+ * @brief Altitud por la fórmula exacta con powf, como referencia
+ *
+ * @param press_pa : presión compensada (Pa)
+ * @param qnh_pa : presión a nivel del mar (Pa)
+ * @return float altitud (m)
+ */
+float Get_Altitude_Exact(float press_pa, float qnh_pa);
+
+/**
+ * @brief Altitud, altura relativa y velocidad vertical de un lote de muestras
+ *
+ * @param state : estado, se actualiza con la última muestra
+ * @param press_pa : presiones compensadas (Pa)
+ * @param time_us : instante de cada muestra (us)
+ * @param out : parámetro de salida
+ * @param n : número de muestras
+ */
+void Get_Altitude_Batch(struct AltitudeState *state, const float *press_pa, const uint32_t *time_us,
+                        struct AltitudeSample *out, uint16_t n);
+
+/**
+ * @brief Memoria estática de la tabla de altitud
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Altitude_Footprint();
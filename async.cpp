@@ -0,0 +1,471 @@
+#include "async.h"
+#include "compensation.h"
+
+#define OSR_P_MASK 0x07
+#define OSR_T_SHIFT 3
+#define PWR_MODE_MASK 0x30
+#define PWR_MEASURE_EN (PWR_PRESS_EN | PWR_TEMP_EN)
+#define CALIB_BYTES 21 // De NVM_PAR_T1 a NVM_PAR_P11
+#define ASYNC_TICK_US (1000 * portTICK_PERIOD_MS)
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+static TransportEnum_t Driver_Read(void *ctx, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    return Transport_Read(reg_addr, data, len);
+}
+
+static TransportEnum_t Driver_Write(void *ctx, uint8_t reg_addr, uint8_t data)
+{
+    (void)ctx;
+    return Transport_Write(reg_addr, data);
+}
+
+static TransportEnum_t I2C_Addr_Read(void *ctx, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return Transport_I2C_Read((uint8_t)(uintptr_t)ctx, reg_addr, data, len);
+}
+
+static TransportEnum_t I2C_Addr_Write(void *ctx, uint8_t reg_addr, uint8_t data)
+{
+    return Transport_I2C_Write((uint8_t)(uintptr_t)ctx, reg_addr, data);
+}
+
+static TransportEnum_t Sensor_Read(struct AsyncSensor *sensor, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return sensor->bus.read(sensor->bus.ctx, reg_addr, data, len);
+}
+
+static TransportEnum_t Sensor_Write(struct AsyncSensor *sensor, uint8_t reg_addr, uint8_t data)
+{
+    return sensor->bus.write(sensor->bus.ctx, reg_addr, data);
+}
+
+/**
+ * @brief Calibración a partir de la ráfaga de NVM_PAR_T1 a NVM_PAR_P11 (little endian)
+ */
+static void Parse_Calib(const uint8_t *nvm, struct RegCalibData *reg)
+{
+    reg->nvm_par_t1 = (uint16_t)(nvm[1] << 8 | nvm[0]);
+    reg->nvm_par_t2 = (uint16_t)(nvm[3] << 8 | nvm[2]);
+    reg->nvm_par_t3 = (int8_t)nvm[4];
+    reg->nvm_par_p1 = (int16_t)(nvm[6] << 8 | nvm[5]);
+    reg->nvm_par_p2 = (int16_t)(nvm[8] << 8 | nvm[7]);
+    reg->nvm_par_p3 = (int8_t)nvm[9];
+    reg->nvm_par_p4 = (int8_t)nvm[10];
+    reg->nvm_par_p5 = (uint16_t)(nvm[12] << 8 | nvm[11]);
+    reg->nvm_par_p6 = (uint16_t)(nvm[14] << 8 | nvm[13]);
+    reg->nvm_par_p7 = (int8_t)nvm[15];
+    reg->nvm_par_p8 = (int8_t)nvm[16];
+    reg->nvm_par_p9 = (int16_t)(nvm[18] << 8 | nvm[17]);
+    reg->nvm_par_p10 = (int8_t)nvm[19];
+    reg->nvm_par_p11 = (int8_t)nvm[20];
+}
+
+/**
+ * @brief Tiempo de conversión en modo forzado según la hoja de datos
+ *
+ * @param osr : contenido del registro OSR
+ * @return uint32_t tiempo en us
+ */
+static uint32_t Conversion_Time_Us(uint8_t osr)
+{
+    uint32_t osr_p = 1 << (osr & OSR_P_MASK);
+    uint32_t osr_t = 1 << ((osr >> OSR_T_SHIFT) & OSR_P_MASK);
+
+    return 234 + (392 + osr_p * 2020) + (163 + osr_t * 2020);
+}
+
+/**
+ * @brief Comprueba si ha llegado el instante de sondeo
+ */
+static bool Is_Due(uint32_t now, uint32_t wake)
+{
+    return (int32_t)(now - wake) >= 0;
+}
+
+/**
+ * @brief Reserva del sensor para la operación; si lo usa otra, se espera a su siguiente
+ * instante de sondeo
+ *
+ * @return true si la operación puede avanzar
+ */
+static bool Acquire(struct AsyncTask *task, uint32_t now)
+{
+    struct AsyncSensor *sensor = task->sensor;
+
+    if (sensor->owner == NULL)
+    {
+        sensor->owner = task;
+    }
+    if (sensor->owner == task)
+    {
+        return true;
+    }
+    uint32_t owner_wake = sensor->owner->wake_us;
+    task->wake_us = Is_Due(now, owner_wake) ? now + ASYNC_POLL_US : owner_wake;
+    return false;
+}
+
+/**
+ * @brief Vuelta de PWR_CTRL a los canales que tenía antes de la medida. El modo forzado
+ * ya deja el sensor en sleep; en modo normal no se tocó.
+ */
+static TransportEnum_t Restore_Pwr_Ctrl(struct AsyncSensor *sensor)
+{
+    uint8_t saved = sensor->pwr_ctrl;
+
+    if ((saved & PWR_MODE_MASK) == MODE_NORMAL || (saved & PWR_MEASURE_EN) == PWR_MEASURE_EN)
+    {
+        return TRANSPORT_SUCCESS;
+    }
+    return Sensor_Write(sensor, REG_PWR_CNTRL, saved & ~PWR_MODE_MASK);
+}
+
+/**
+ * @brief Fin de la operación: libera el sensor y, si una medida se quedó a medias,
+ * intenta restaurar PWR_CTRL
+ */
+static void Release(struct AsyncTask *task)
+{
+    struct AsyncSensor *sensor = task->sensor;
+
+    if (sensor->owner != task)
+    {
+        return;
+    }
+    if (task->status == ASYNC_FAILED && task->op == ASYNC_OP_MEASURE && task->step > 0)
+    {
+        Restore_Pwr_Ctrl(sensor);
+    }
+    sensor->owner = NULL;
+}
+
+/**
+ * @brief Paso de la medida
+ */
+static AsyncEnum_t Step_Measure(struct AsyncTask *task, uint32_t now)
+{
+    struct AsyncSensor *sensor = task->sensor;
+    uint8_t data[6];
+
+    switch (task->step)
+    {
+    case 0:
+        // PWR_CTRL y OSR son consecutivos
+        if (Sensor_Read(sensor, REG_PWR_CNTRL, data, 2) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        sensor->pwr_ctrl = data[0];
+        task->step = 1;
+        if ((data[0] & PWR_MODE_MASK) == MODE_NORMAL)
+        {
+            // En modo normal se lee la siguiente conversión sin parar al resto
+            task->wake_us = now;
+            return ASYNC_PENDING;
+        }
+        if (Sensor_Write(sensor, REG_PWR_CNTRL, PWR_MEASURE_EN | MODE_FORCED) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        task->wake_us = now + Conversion_Time_Us(data[1]);
+        return ASYNC_PENDING;
+
+    case 1:
+        if (Sensor_Read(sensor, REG_STATUS, data, 1) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        if (!(data[0] & (1 << STATUS_DRDY_PRESS)) || !(data[0] & (1 << STATUS_DRDY_TEMP)))
+        {
+            task->wake_us = now + ASYNC_POLL_US;
+            return ASYNC_PENDING;
+        }
+        task->step = 2;
+        // fall through
+
+    case 2:
+        // Presión y temperatura en una sola ráfaga desde REG_PRESS
+        if (Sensor_Read(sensor, REG_PRESS, data, 6) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        {
+            uint32_t uncomp_press = ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+            uint32_t uncomp_temp = ((uint32_t)data[5] << 16) | ((uint32_t)data[4] << 8) | data[3];
+            task->temp = Compensate_Temperature_Float(&sensor->coeff, uncomp_temp);
+            task->press = Compensate_Pressure_Float(&sensor->coeff, uncomp_press, task->temp);
+        }
+        return Restore_Pwr_Ctrl(sensor) == TRANSPORT_SUCCESS ? ASYNC_DONE : ASYNC_FAILED;
+
+    default:
+        return ASYNC_FAILED;
+    }
+}
+
+/**
+ * @brief Paso de la descarga de la FIFO
+ */
+static AsyncEnum_t Step_Drain_FIFO(struct AsyncTask *task)
+{
+    struct AsyncSensor *sensor = task->sensor;
+    uint8_t data[2];
+    uint16_t len;
+
+    switch (task->step)
+    {
+    case 0:
+        if (Sensor_Read(sensor, REG_FIFO_LENGTH, data, 2) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        len = ((uint16_t)data[1] << 8 | data[0]) & 0x01FF;
+        if (len == 0)
+        {
+            task->count = 0;
+            return ASYNC_DONE;
+        }
+        // 4 bytes más para la trama de sensortime
+        len += 4;
+        task->raw_len = len > FIFO_MAX_BYTES ? FIFO_MAX_BYTES : len;
+        task->step = 1;
+        return ASYNC_PENDING;
+
+    case 1:
+        // La lectura va en un paso aparte para que otras operaciones se intercalen
+        if (Sensor_Read(sensor, REG_FIFO_DATA, task->raw, task->raw_len) != TRANSPORT_SUCCESS)
+        {
+            return ASYNC_FAILED;
+        }
+        task->count = Parse_FIFO(task->raw, task->raw_len, task->samples, task->max_samples, NULL);
+        return ASYNC_DONE;
+
+    default:
+        return ASYNC_FAILED;
+    }
+}
+
+static void Prepare(struct AsyncTask *task, AsyncOp_t op, struct AsyncSensor *sensor, AsyncCallback_t callback,
+                    void *user)
+{
+    task->op = op;
+    task->status = ASYNC_PENDING;
+    task->step = 0;
+    task->sensor = sensor;
+    task->start_us = micros();
+    task->wake_us = task->start_us;
+    task->callback = callback;
+    task->user = user;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Bus del driver (el elegido con Init_BMP_Transport) para un AsyncSensor
+ *
+ * @param bus : parámetro de salida
+ */
+void Async_Transport_Bus(struct AsyncBus *bus)
+{
+    bus->read = Driver_Read;
+    bus->write = Driver_Write;
+    bus->ctx = NULL;
+}
+
+/**
+ * @brief Bus i2c con dirección propia para un AsyncSensor (requiere Init_I2C)
+ *
+ * @param bus : parámetro de salida
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ */
+void Async_I2C_Bus(struct AsyncBus *bus, uint8_t i2c_addr)
+{
+    bus->read = I2C_Addr_Read;
+    bus->write = I2C_Addr_Write;
+    bus->ctx = (void *)(uintptr_t)i2c_addr;
+}
+
+/**
+ * @brief Inicialización de un sensor: lee su calibración por su bus
+ *
+ * @param sensor : sensor
+ * @param bus : bus del sensor
+ * @return AsyncEnum_t ASYNC_DONE o ASYNC_FAILED si no se lee la calibración
+ */
+AsyncEnum_t Init_Async_Sensor(struct AsyncSensor *sensor, const struct AsyncBus *bus)
+{
+    uint8_t nvm[CALIB_BYTES];
+    struct RegCalibData reg;
+
+    sensor->bus = *bus;
+    sensor->owner = NULL;
+    sensor->pwr_ctrl = 0;
+    if (Sensor_Read(sensor, NVM_PAR_T1, nvm, CALIB_BYTES) != TRANSPORT_SUCCESS)
+    {
+        return ASYNC_FAILED;
+    }
+    Parse_Calib(nvm, &reg);
+    Calc_Coefficients(&reg, &sensor->coeff);
+    return ASYNC_DONE;
+}
+
+/**
+ * @brief Prepara una medida con compensación en float. En sleep el sensor hace una
+ * conversión en modo forzado y vuelve a sleep con los canales que tenía; en modo normal
+ * no se toca PWR_CTRL y se lee la siguiente conversión.
+ *
+ * @param task : operación
+ * @param sensor : sensor
+ * @param callback : se llama al terminar (puede ser NULL)
+ * @param user : dato del usuario para el callback
+ */
+void Async_Measure(struct AsyncTask *task, struct AsyncSensor *sensor, AsyncCallback_t callback, void *user)
+{
+    Prepare(task, ASYNC_OP_MEASURE, sensor, callback, user);
+}
+
+/**
+ * @brief Prepara una descarga de la FIFO
+ *
+ * @param task : operación
+ * @param sensor : sensor
+ * @param raw : buffer de trabajo de FIFO_MAX_BYTES
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param callback : se llama al terminar (puede ser NULL)
+ * @param user : dato del usuario para el callback
+ */
+void Async_Drain_FIFO(struct AsyncTask *task, struct AsyncSensor *sensor, uint8_t *raw, struct FifoSample *samples,
+                      uint16_t max_samples, AsyncCallback_t callback, void *user)
+{
+    Prepare(task, ASYNC_OP_DRAIN_FIFO, sensor, callback, user);
+    task->raw = raw;
+    task->raw_len = 0;
+    task->samples = samples;
+    task->max_samples = max_samples;
+    task->count = 0;
+}
+
+/**
+ * @brief Avanza la operación un paso si ha llegado su instante; nunca espera. Una
+ * operación no empieza mientras otra use el mismo sensor. El callback puede preparar y
+ * enviar otra operación, incluso sobre la misma AsyncTask.
+ *
+ * @param task : operación
+ * @return AsyncEnum_t pendiente/terminada/fallida
+ */
+AsyncEnum_t Async_Poll(struct AsyncTask *task)
+{
+    if (task->status != ASYNC_PENDING)
+    {
+        return task->status;
+    }
+
+    uint32_t now = micros();
+    if (now - task->start_us > ASYNC_TIMEOUT_US)
+    {
+        task->status = ASYNC_FAILED;
+    }
+    else if (Is_Due(now, task->wake_us) && Acquire(task, now))
+    {
+        task->status = (task->op == ASYNC_OP_MEASURE) ? Step_Measure(task, now) : Step_Drain_FIFO(task);
+    }
+
+    // El callback puede reutilizar la tarea: el resultado se guarda antes
+    AsyncEnum_t status = task->status;
+    if (status != ASYNC_PENDING)
+    {
+        Release(task);
+        if (task->callback != NULL)
+        {
+            task->callback(task);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Inicialización del ejecutor
+ *
+ * @param exec : ejecutor
+ */
+void Init_Async_Executor(struct AsyncExecutor *exec)
+{
+    exec->count = 0;
+}
+
+/**
+ * @brief Añade una operación al ejecutor
+ *
+ * @param exec : ejecutor
+ * @param task : operación preparada con Async_Measure o Async_Drain_FIFO
+ * @return AsyncEnum_t ASYNC_PENDING o ASYNC_FAILED si el ejecutor está lleno
+ */
+AsyncEnum_t Async_Submit(struct AsyncExecutor *exec, struct AsyncTask *task)
+{
+    if (exec->count >= ASYNC_MAX_TASKS)
+    {
+        return ASYNC_FAILED;
+    }
+    exec->tasks[exec->count++] = task;
+    return ASYNC_PENDING;
+}
+
+/**
+ * @brief Sondea una vez todas las operaciones y retira las terminadas
+ *
+ * @param exec : ejecutor
+ * @return uint32_t microsegundos hasta el primer instante de sondeo, ASYNC_NO_WAKE si no
+ * quedan operaciones
+ */
+uint32_t Async_Run_Once(struct AsyncExecutor *exec)
+{
+    uint32_t next_us = ASYNC_NO_WAKE;
+    uint8_t i = 0;
+
+    while (i < exec->count)
+    {
+        struct AsyncTask *task = exec->tasks[i];
+        if (Async_Poll(task) != ASYNC_PENDING)
+        {
+            // Si el callback la volvió a enviar, la copia del final ocupa su hueco y se
+            // sondea en esta misma vuelta
+            exec->tasks[i] = exec->tasks[--exec->count];
+            continue;
+        }
+
+        int32_t wait = (int32_t)(task->wake_us - micros());
+        if (wait <= 0)
+        {
+            next_us = 0;
+        }
+        else if ((uint32_t)wait < next_us)
+        {
+            next_us = wait;
+        }
+        i++;
+    }
+    return next_us;
+}
+
+/**
+ * @brief Ejecuta hasta que no quedan operaciones, bloqueando la tarea hasta el primer
+ * instante de sondeo redondeado a ticks (nunca espera activa)
+ *
+ * @param exec : ejecutor
+ */
+void Async_Run(struct AsyncExecutor *exec)
+{
+    while (exec->count > 0)
+    {
+        uint32_t wait_us = Async_Run_Once(exec);
+        if (wait_us == 0 || wait_us == ASYNC_NO_WAKE)
+        {
+            continue;
+        }
+        // Hacia arriba: sondear hasta un tick tarde cuesta menos que esperar en activo
+        vTaskDelay((wait_us + ASYNC_TICK_US - 1) / ASYNC_TICK_US);
+    }
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Arduino.h"
+#include "def.h"
+#include "fifo.h"
+#include "transport.h"
+
+// Máximo de operaciones que un ejecutor atiende a la vez
+#ifndef ASYNC_MAX_TASKS
+#define ASYNC_MAX_TASKS         8
+#endif
+
+// Intervalo de sondeo del estado mientras la conversión no ha terminado (us)
+#define ASYNC_POLL_US           500
+
+// Plazo máximo de una operación (us)
+#define ASYNC_TIMEOUT_US        200000
+
+// Async_Run_Once sin operaciones pendientes
+#define ASYNC_NO_WAKE           UINT32_MAX
+
+typedef enum
+{
+    ASYNC_IDLE = 0,
+    ASYNC_PENDING,
+    ASYNC_DONE,
+    ASYNC_FAILED
+} AsyncEnum_t;
+
+typedef enum
+{
+    ASYNC_OP_MEASURE = 0,
+    ASYNC_OP_DRAIN_FIFO
+} AsyncOp_t;
+
+struct AsyncTask;
+
+typedef void (*AsyncCallback_t)(struct AsyncTask *task);
+
+/*! Acceso de un sensor a su bus; ctx distingue sensores en el mismo tipo de bus */
+struct AsyncBus
+{
+    TransportEnum_t (*read)(void *ctx, uint8_t reg_addr, uint8_t *data, uint16_t len);
+    TransportEnum_t (*write)(void *ctx, uint8_t reg_addr, uint8_t data);
+    void *ctx;
+};
+
+/*! Sensor atendido por un ejecutor: bus, coeficientes propios y operación en curso */
+struct AsyncSensor
+{
+    struct AsyncBus bus;
+    struct DataCoefficients coeff;
+    struct AsyncTask *owner; // Operación que usa el sensor; las demás esperan a que termine
+    uint8_t pwr_ctrl;        // PWR_CTRL antes de la medida, para restaurarlo
+};
+
+/*! Operación asíncrona: una máquina de estados que avanza un paso en cada sondeo */
+struct AsyncTask
+{
+    AsyncOp_t op;
+    AsyncEnum_t status;
+    uint8_t step;
+    struct AsyncSensor *sensor;
+    uint32_t start_us;
+    uint32_t wake_us; // No se sondea antes de este instante
+    AsyncCallback_t callback;
+    void *user;
+
+    // Resultado de ASYNC_OP_MEASURE
+    float press;
+    float temp;
+
+    // Buffers y resultado de ASYNC_OP_DRAIN_FIFO
+    uint8_t *raw;
+    uint16_t raw_len;
+    struct FifoSample *samples;
+    uint16_t max_samples;
+    uint16_t count;
+};
+
+/*! Ejecutor de un solo hilo: reparte una tarea entre varias operaciones de varios sensores */
+struct AsyncExecutor
+{
+    struct AsyncTask *tasks[ASYNC_MAX_TASKS];
+    uint8_t count;
+};
+
+/**
+ * @brief Bus del driver (el elegido con Init_BMP_Transport) para un AsyncSensor
+ *
+ * @param bus : parámetro de salida
+ */
+void Async_Transport_Bus(struct AsyncBus *bus);
+
+/**
+ * @brief Bus i2c con dirección propia para un AsyncSensor: por el backend de ESP-IDF
+ * si es el transporte elegido y, si no, por Wire (requiere Init_I2C)
+ *
+ * @param bus : parámetro de salida
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ */
+void Async_I2C_Bus(struct AsyncBus *bus, uint8_t i2c_addr);
+
+/**
+ * @brief Inicialización de un sensor: lee su calibración por su bus
+ *
+ * @param sensor : sensor
+ * @param bus : bus del sensor
+ * @return AsyncEnum_t ASYNC_DONE o ASYNC_FAILED si no se lee la calibración
+ */
+AsyncEnum_t Init_Async_Sensor(struct AsyncSensor *sensor, const struct AsyncBus *bus);
+
+/**
+ * @brief Prepara una medida con compensación en float. En sleep el sensor hace una
+ * conversión en modo forzado y vuelve a sleep con los canales que tenía; en modo normal
+ * no se toca PWR_CTRL y se lee la siguiente conversión.
+ *
+ * @param task : operación
+ * @param sensor : sensor
+ * @param callback : se llama al terminar (puede ser NULL)
+ * @param user : dato del usuario para el callback
+ */
+void Async_Measure(struct AsyncTask *task, struct AsyncSensor *sensor, AsyncCallback_t callback, void *user);
+
+/**
+ * @brief Prepara una descarga de la FIFO
+ *
+ * @param task : operación
+ * @param sensor : sensor
+ * @param raw : buffer de trabajo de FIFO_MAX_BYTES
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param callback : se llama al terminar (puede ser NULL)
+ * @param user : dato del usuario para el callback
+ */
+void Async_Drain_FIFO(struct AsyncTask *task, struct AsyncSensor *sensor, uint8_t *raw, struct FifoSample *samples,
+                      uint16_t max_samples, AsyncCallback_t callback, void *user);
+
+/**
+ * @brief Avanza la operación un paso si ha llegado su instante; nunca espera. Una
+ * operación no empieza mientras otra use el mismo sensor. El callback puede preparar y
+ * enviar otra operación, incluso sobre la misma AsyncTask.
+ *
+ * @param task : operación
+ * @return AsyncEnum_t pendiente/terminada/fallida
+ */
+AsyncEnum_t Async_Poll(struct AsyncTask *task);
+
+/**
+ * @brief Inicialización del ejecutor
+ *
+ * @param exec : ejecutor
+ */
+void Init_Async_Executor(struct AsyncExecutor *exec);
+
+/**
+ * @brief Añade una operación al ejecutor
+ *
+ * @param exec : ejecutor
+ * @param task : operación preparada con Async_Measure o Async_Drain_FIFO
+ * @return AsyncEnum_t ASYNC_PENDING o ASYNC_FAILED si el ejecutor está lleno
+ */
+AsyncEnum_t Async_Submit(struct AsyncExecutor *exec, struct AsyncTask *task);
+
+/**
+ * @brief Sondea una vez todas las operaciones y retira las terminadas
+ *
+ * @param exec : ejecutor
+ * @return uint32_t microsegundos hasta el primer instante de sondeo, ASYNC_NO_WAKE si no
+ * quedan operaciones
+ */
+uint32_t Async_Run_Once(struct AsyncExecutor *exec);
+
+/**
+ * @brief Ejecuta hasta que no quedan operaciones, bloqueando la tarea hasta el primer
+ * instante de sondeo redondeado a ticks (nunca espera activa)
+ *
+ * @param exec : ejecutor
+ */
+void Async_Run(struct AsyncExecutor *exec);
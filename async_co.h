@@ -0,0 +1,106 @@
+#pragma once
+
+/*
+ * Corrutinas C++20 sobre el ejecutor de async.h:
+ *
+ *   AsyncCoroutine Leer(AsyncSensorCo &sensor)
+ *   {
+ *       struct AsyncTask rslt = co_await sensor.measure();
+ *       if (rslt.status == ASYNC_DONE) ...
+ *       rslt = co_await sensor.drain_fifo(raw, samples, max_samples);
+ *   }
+ *
+ * Cada co_await prepara una AsyncTask en el marco de la corrutina, la envía al ejecutor
+ * y la corrutina se reanuda desde el callback, en la tarea que ejecuta Async_Run. Varias
+ * corrutinas sobre varios sensores comparten un mismo ejecutor. El marco se reserva con
+ * new al llamar a la corrutina, no en cada co_await.
+ *
+ * Sin soporte de corrutinas (p. ej. con -std=gnu++17) la cabecera no declara nada y queda
+ * la API de callbacks de async.h.
+ */
+
+#include "async.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+
+/*! Corrutina lanzada y olvidada: empieza al llamarla y libera su marco al terminar */
+struct AsyncCoroutine
+{
+    struct promise_type
+    {
+        AsyncCoroutine get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/*! Operación en espera: se envía al suspender y devuelve una copia de la AsyncTask */
+class AsyncAwaiter
+{
+public:
+    AsyncAwaiter(struct AsyncExecutor *exec, struct AsyncSensor *sensor) : exec(exec)
+    {
+        Async_Measure(&task, sensor, Resume, NULL);
+    }
+
+    AsyncAwaiter(struct AsyncExecutor *exec, struct AsyncSensor *sensor, uint8_t *raw, struct FifoSample *samples,
+                 uint16_t max_samples)
+        : exec(exec)
+    {
+        Async_Drain_FIFO(&task, sensor, raw, samples, max_samples, Resume, NULL);
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        task.user = handle.address();
+        if (Async_Submit(exec, &task) != ASYNC_PENDING)
+        {
+            // Ejecutor lleno: se sigue sin suspender y la operación consta como fallida
+            task.status = ASYNC_FAILED;
+            return false;
+        }
+        return true;
+    }
+
+    struct AsyncTask await_resume() const noexcept { return task; }
+
+private:
+    struct AsyncExecutor *exec;
+    struct AsyncTask task;
+
+    static void Resume(struct AsyncTask *task)
+    {
+        std::coroutine_handle<>::from_address(task->user).resume();
+    }
+};
+
+/*! Sensor visto desde una corrutina */
+class AsyncSensorCo
+{
+public:
+    AsyncSensorCo(struct AsyncExecutor *exec, struct AsyncSensor *sensor) : exec(exec), sensor(sensor) {}
+
+    /**
+     * @brief Medida (ver Async_Measure)
+     */
+    AsyncAwaiter measure() { return AsyncAwaiter(exec, sensor); }
+
+    /**
+     * @brief Descarga de la FIFO (ver Async_Drain_FIFO)
+     */
+    AsyncAwaiter drain_fifo(uint8_t *raw, struct FifoSample *samples, uint16_t max_samples)
+    {
+        return AsyncAwaiter(exec, sensor, raw, samples, max_samples);
+    }
+
+private:
+    struct AsyncExecutor *exec;
+    struct AsyncSensor *sensor;
+};
+#endif
@@ -0,0 +1,263 @@
+#include "bus.h"
+
+static SemaphoreHandle_t bus_mutex = NULL;
+static StaticSemaphore_t bus_mutex_buffer;
+static portMUX_TYPE bus_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t pending_high = 0;
+static uint32_t lock_depth = 0;
+static uint32_t lock_start_us = 0;
+static BusPriority_t holder_prio = BUS_PRIO_HIGH;
+static struct BusStats bus_stats;
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Ticks completos que quedan del plazo; 0 si queda menos de un tick o nada
+ */
+static TickType_t Remaining_Ticks(uint32_t start, uint32_t timeout_us)
+{
+    uint32_t elapsed = micros() - start;
+    return elapsed < timeout_us ? (timeout_us - elapsed) / (portTICK_PERIOD_MS * 1000) : 0;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/*!
+ * @brief Inicialización del gestor del bus
+ * @return BusLockEnum_t error/success
+ */
+BusLockEnum_t Init_Bus()
+{
+    BusLockEnum_t rtrn = BUS_LOCK_SUCCESS;
+
+    if (bus_mutex == NULL)
+    {
+        bus_mutex = xSemaphoreCreateRecursiveMutexStatic(&bus_mutex_buffer);
+        if (bus_mutex == NULL)
+        {
+            rtrn = BUS_LOCK_FAILED;
+        }
+    }
+    return rtrn;
+}
+
+/**
+ * @brief Toma del bus para una transacción. Es reentrante desde la misma tarea.
+ *
+ * @param prio : prioridad de la transacción
+ * @param timeout_ms : tiempo máximo de espera
+ * @return BusLockEnum_t error/success/timeout
+ */
+BusLockEnum_t Bus_Lock(BusPriority_t prio, uint32_t timeout_ms)
+{
+    // Más de ~71 minutos no cabe en micros(): se satura en lugar de desbordar
+    return Bus_Lock_Us(prio, timeout_ms > UINT32_MAX / 1000 ? UINT32_MAX : timeout_ms * 1000);
+}
+
+/**
+ * @brief Toma del bus con el plazo en microsegundos, para quien reparte un plazo total
+ * entre varios pasos. Con plazo 0 sólo se intenta una vez.
+ *
+ * Una transacción de baja prioridad que consigue el bus mientras hay alguna de alta
+ * esperando lo devuelve y vuelve a intentarlo, de modo que las de alta pasan delante.
+ * Una toma anidada de baja prioridad que alargaría la ocupación más allá de
+ * BUS_HOLD_LIMIT_US con una de alta esperando se rechaza: quien la pide debe soltar
+ * el bus y volver a pedirlo. Por debajo de un tick se espera cediendo la CPU en lugar
+ * de bloquear, para no pasarse del plazo.
+ *
+ * @param prio : prioridad de la transacción
+ * @param timeout_us : tiempo máximo de espera
+ * @return BusLockEnum_t error/success/timeout
+ */
+BusLockEnum_t Bus_Lock_Us(BusPriority_t prio, uint32_t timeout_us)
+{
+    if (bus_mutex == NULL)
+    {
+        return BUS_LOCK_FAILED;
+    }
+
+    // Toma anidada desde la tarea que ya tiene el bus
+    if (xSemaphoreGetMutexHolder(bus_mutex) == xTaskGetCurrentTaskHandle())
+    {
+        if (holder_prio == BUS_PRIO_LOW && pending_high > 0 && micros() - lock_start_us >= BUS_HOLD_LIMIT_US)
+        {
+            portENTER_CRITICAL(&bus_mux);
+            bus_stats.preemptions++;
+            portEXIT_CRITICAL(&bus_mux);
+            return BUS_LOCK_TIMEOUT;
+        }
+        xSemaphoreTakeRecursive(bus_mutex, 0);
+        lock_depth++;
+        return BUS_LOCK_SUCCESS;
+    }
+
+    BusLockEnum_t rtrn = BUS_LOCK_TIMEOUT;
+    uint32_t start = micros();
+    bool contended = false;
+
+    if (prio == BUS_PRIO_HIGH)
+    {
+        portENTER_CRITICAL(&bus_mux);
+        pending_high = pending_high + 1;
+        portEXIT_CRITICAL(&bus_mux);
+    }
+
+    while (true)
+    {
+        if (xSemaphoreTakeRecursive(bus_mutex, 0) != pdTRUE)
+        {
+            contended = true;
+            TickType_t ticks = Remaining_Ticks(start, timeout_us);
+            if (micros() - start >= timeout_us)
+            {
+                break;
+            }
+            if (ticks == 0)
+            {
+                taskYIELD();
+                continue;
+            }
+            if (xSemaphoreTakeRecursive(bus_mutex, ticks) != pdTRUE)
+            {
+                continue;
+            }
+        }
+
+        if (prio == BUS_PRIO_LOW && pending_high > 0)
+        {
+            xSemaphoreGiveRecursive(bus_mutex);
+            contended = true;
+            portENTER_CRITICAL(&bus_mux);
+            bus_stats.yields++;
+            portEXIT_CRITICAL(&bus_mux);
+            if (micros() - start >= timeout_us)
+            {
+                break;
+            }
+            if (Remaining_Ticks(start, timeout_us) > 0)
+            {
+                vTaskDelay(1);
+            }
+            else
+            {
+                taskYIELD();
+            }
+            continue;
+        }
+
+        rtrn = BUS_LOCK_SUCCESS;
+        break;
+    }
+
+    uint32_t wait_us = micros() - start;
+    portENTER_CRITICAL(&bus_mux);
+    if (prio == BUS_PRIO_HIGH)
+    {
+        pending_high = pending_high - 1;
+    }
+    if (rtrn == BUS_LOCK_SUCCESS)
+    {
+        bus_stats.acquisitions++;
+        bus_stats.total_wait_us += wait_us;
+        if (contended)
+        {
+            bus_stats.contended++;
+        }
+        if (wait_us > bus_stats.max_wait_us)
+        {
+            bus_stats.max_wait_us = wait_us;
+        }
+    }
+    else
+    {
+        bus_stats.timeouts++;
+    }
+    portEXIT_CRITICAL(&bus_mux);
+
+    if (rtrn == BUS_LOCK_SUCCESS)
+    {
+        lock_depth = 1;
+        holder_prio = prio;
+        lock_start_us = micros();
+    }
+    return rtrn;
+}
+
+/*!
+ * @brief Liberación del bus
+ */
+void Bus_Unlock()
+{
+    if (bus_mutex == NULL || lock_depth == 0 || xSemaphoreGetMutexHolder(bus_mutex) != xTaskGetCurrentTaskHandle())
+    {
+        return;
+    }
+
+    lock_depth--;
+    if (lock_depth == 0)
+    {
+        uint32_t hold_us = micros() - lock_start_us;
+        portENTER_CRITICAL(&bus_mux);
+        bus_stats.total_hold_us += hold_us;
+        if (hold_us > bus_stats.max_hold_us)
+        {
+            bus_stats.max_hold_us = hold_us;
+        }
+        if (hold_us > BUS_HOLD_LIMIT_US)
+        {
+            bus_stats.hold_overruns++;
+        }
+        portEXIT_CRITICAL(&bus_mux);
+    }
+    xSemaphoreGiveRecursive(bus_mutex);
+}
+
+/**
+ * @brief Bytes de datos que caben en una ocupación de BUS_HOLD_LIMIT_US
+ *
+ * @param clock_hz : reloj del bus
+ * @param bits_per_byte : 9 en i2c (ACK incluido), 8 en spi
+ * @param overhead_bytes : bytes de cabecera de la transacción (direcciones, registro, relleno)
+ * @param max_bytes : límite del backend
+ * @return uint16_t bytes por trozo, al menos 1
+ */
+uint16_t Bus_Hold_Chunk(uint32_t clock_hz, uint8_t bits_per_byte, uint8_t overhead_bytes, uint16_t max_bytes)
+{
+    uint64_t bytes = (uint64_t)BUS_HOLD_LIMIT_US * clock_hz / 1000000 / bits_per_byte;
+
+    bytes = bytes > overhead_bytes ? bytes - overhead_bytes : 1;
+    return bytes > max_bytes ? max_bytes : (uint16_t)bytes;
+}
+
+/**
+ * @brief Obtención de las métricas de contención
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_Bus_Stats(struct BusStats *stats)
+{
+    portENTER_CRITICAL(&bus_mux);
+    *stats = bus_stats;
+    portEXIT_CRITICAL(&bus_mux);
+}
+
+/*!
+ * @brief Puesta a cero de las métricas de contención
+ */
+void Reset_Bus_Stats()
+{
+    portENTER_CRITICAL(&bus_mux);
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    portEXIT_CRITICAL(&bus_mux);
+}
+
+/**
+ * @brief Memoria estática del gestor del bus
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Bus_Footprint()
+{
+    return sizeof(bus_mutex) + sizeof(bus_mutex_buffer) + sizeof(bus_mux) + sizeof(pending_high) + sizeof(lock_depth) +
+           sizeof(lock_start_us) + sizeof(holder_prio) + sizeof(bus_stats);
+}
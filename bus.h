@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Arduino.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// Tiempo máximo de espera por el bus (ms)
+#define BUS_TIMEOUT_MS          20
+
+// Ocupación máxima del bus por una transacción de baja prioridad (us). Las descargas
+// largas se trocean con Bus_Hold_Chunk() y una toma anidada de baja prioridad que ya
+// ha superado el límite se rechaza si hay una de alta esperando.
+#define BUS_HOLD_LIMIT_US       2000
+
+typedef enum
+{
+    BUS_LOCK_FAILED = 0,
+    BUS_LOCK_SUCCESS,
+    BUS_LOCK_TIMEOUT
+} BusLockEnum_t;
+
+/*! Prioridad de la transacción: las lecturas del sensor pasan delante de las descargas de FIFO */
+typedef enum
+{
+    BUS_PRIO_LOW = 0,
+    BUS_PRIO_HIGH
+} BusPriority_t;
+
+/*! Métricas de contención del bus */
+struct BusStats
+{
+    uint32_t acquisitions;  // Número de veces que se ha tomado el bus
+    uint32_t contended;     // Tomas en las que el bus estaba ocupado
+    uint32_t timeouts;      // Tomas que han superado el tiempo de espera
+    uint32_t yields;        // Cesiones de transacciones de baja prioridad a las de alta
+    uint32_t hold_overruns; // Ocupaciones que superan BUS_HOLD_LIMIT_US
+    uint32_t preemptions;   // Tomas anidadas de baja prioridad rechazadas por superar el límite
+    uint32_t max_wait_us;   // Máxima espera hasta tomar el bus
+    uint32_t max_hold_us;   // Máxima ocupación del bus
+    uint64_t total_wait_us; // Espera acumulada (64 bits: en 32 se desborda a los ~71 minutos)
+    uint64_t total_hold_us; // Ocupación acumulada
+};
+
+/*!
+ * @brief Inicialización del gestor del bus
+ * @return BusLockEnum_t error/success
+ */
+BusLockEnum_t Init_Bus();
+
+/**
+ * @brief Toma del bus para una transacción. Es reentrante desde la misma tarea.
+ *
+ * @param prio : prioridad de la transacción
+ * @param timeout_ms : tiempo máximo de espera
+ * @return BusLockEnum_t error/success/timeout
+ */
+BusLockEnum_t Bus_Lock(BusPriority_t prio, uint32_t timeout_ms);
+
+/**
+ * @brief Toma del bus con el plazo en microsegundos, para quien reparte un plazo total
+ * entre varios pasos. Con plazo 0 sólo se intenta una vez.
+ *
+ * @param prio : prioridad de la transacción
+ * @param timeout_us : tiempo máximo de espera
+ * @return BusLockEnum_t error/success/timeout
+ */
+BusLockEnum_t Bus_Lock_Us(BusPriority_t prio, uint32_t timeout_us);
+
+/*!
+ * @brief Liberación del bus
+ */
+void Bus_Unlock();
+
+/**
+ * @brief Bytes de datos que caben en una ocupación de BUS_HOLD_LIMIT_US
+ *
+ * @param clock_hz : reloj del bus
+ * @param bits_per_byte : 9 en i2c (ACK incluido), 8 en spi
+ * @param overhead_bytes : bytes de cabecera de la transacción (direcciones, registro, relleno)
+ * @param max_bytes : límite del backend
+ * @return uint16_t bytes por trozo, al menos 1
+ */
+uint16_t Bus_Hold_Chunk(uint32_t clock_hz, uint8_t bits_per_byte, uint8_t overhead_bytes, uint16_t max_bytes);
+
+/**
+ * @brief Obtención de las métricas de contención
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_Bus_Stats(struct BusStats *stats);
+
+/*!
+ * @brief Puesta a cero de las métricas de contención
+ */
+void Reset_Bus_Stats();
+
+/**
+ * @brief Memoria estática del gestor del bus
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Bus_Footprint();
@@ -0,0 +1,198 @@
+#include "comp_lut.h"
+#include "compensation.h"
+#include "math.h"
+
+// Lectura máxima de 24 bits
+#define RAW_MAX 0xFFFFFF
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Lectura sin compensar que da una presión a una temperatura
+ */
+static uint32_t Find_Uncomp_Press(const struct DataCoefficients *coeff, float press, float temp)
+{
+    uint32_t low = 0;
+    uint32_t high = RAW_MAX;
+
+    // La presión es monótona con la lectura en el rango del sensor, en el sentido que marquen los extremos
+    bool decreasing = Compensate_Pressure_Float(coeff, low, temp) > Compensate_Pressure_Float(coeff, high, temp);
+    while (high - low > 1)
+    {
+        uint32_t mid = (low + high) / 2;
+        if ((Compensate_Pressure_Float(coeff, mid, temp) < press) != decreasing)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Cálculo de una fila de temperatura
+ */
+static void Build_Row(struct CompLut *lut, uint16_t row)
+{
+    float temp = lut->temp_min + row * lut->temp_step;
+    float *values = &lut->table[(uint32_t)row * lut->n_press];
+
+    for (uint16_t i = 0; i < lut->n_press; i++)
+    {
+        values[i] = Compensate_Pressure_Float(&lut->coeff, lut->raw_min + ((uint32_t)i << lut->raw_shift), temp);
+    }
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Preparación y cálculo de la tabla completa
+ *
+ * Con el paso redondeado a potencia de 2 puede bastar con menos columnas que
+ * config->n_press para cubrir el rango; lut->n_press queda con las usadas.
+ *
+ * @param lut : tabla
+ * @param coeff : coeficientes del sensor
+ * @param config : rango y tamaño de la rejilla
+ * @param table : búfer de valores
+ * @param table_len : capacidad del búfer en valores
+ * @return CompLutEnum_t error/success
+ */
+CompLutEnum_t Init_Comp_LUT(struct CompLut *lut, const struct DataCoefficients *coeff,
+                            const struct CompLutConfig *config, float *table, uint32_t table_len)
+{
+    if (config->n_temp < COMP_LUT_MIN_POINTS || config->n_press < COMP_LUT_MIN_POINTS ||
+        !(config->temp_max > config->temp_min) || !(config->press_max > config->press_min) || table == NULL ||
+        (uint32_t)config->n_temp * config->n_press > table_len)
+    {
+        return COMP_LUT_FAILED;
+    }
+
+    lut->coeff = *coeff;
+    lut->n_temp = config->n_temp;
+    lut->table = table;
+
+    lut->temp_min = config->temp_min;
+    lut->temp_step = (config->temp_max - config->temp_min) / (config->n_temp - 1);
+    lut->temp_inv_step = 1.0f / lut->temp_step;
+    lut->temp_span = config->n_temp - 1;
+
+    // Lecturas extremas del rango de presión en cada fila: el desplazamiento es cúbico
+    // en temperatura y el extremo puede caer en una fila intermedia
+    uint32_t raw_min = RAW_MAX;
+    uint32_t raw_max = 0;
+    for (uint16_t row = 0; row < config->n_temp; row++)
+    {
+        float temp = lut->temp_min + row * lut->temp_step;
+        uint32_t raw_low = Find_Uncomp_Press(coeff, config->press_min, temp);
+        uint32_t raw_high = Find_Uncomp_Press(coeff, config->press_max, temp);
+        if (raw_low > raw_high)
+        {
+            uint32_t raw = raw_low;
+            raw_low = raw_high;
+            raw_high = raw;
+        }
+        raw_min = raw_low < raw_min ? raw_low : raw_min;
+        raw_max = raw_high + 1 > raw_max ? raw_high + 1 : raw_max;
+    }
+    if (raw_max - raw_min < config->n_press)
+    {
+        return COMP_LUT_FAILED;
+    }
+
+    // Menor potencia de 2 con la que n_press columnas cubren el rango
+    uint8_t shift = 0;
+    while (((uint32_t)(config->n_press - 1) << shift) < raw_max - raw_min)
+    {
+        shift++;
+    }
+    lut->raw_min = raw_min;
+    lut->raw_shift = shift;
+    lut->n_press = ((raw_max - raw_min + (1u << shift) - 1) >> shift) + 1;
+    lut->raw_span = (uint32_t)(lut->n_press - 1) << shift;
+    lut->raw_inv_step = 1.0f / (1u << shift);
+
+    for (uint16_t row = 0; row < lut->n_temp; row++)
+    {
+        Build_Row(lut, row);
+    }
+    return COMP_LUT_SUCCESS;
+}
+
+/**
+ * @brief Presión compensada por interpolación bilineal
+ *
+ * @param lut : tabla
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return float presión (Pa)
+ */
+float Comp_LUT_Pressure(const struct CompLut *lut, uint32_t uncomp_press, float temp)
+{
+    float x = (temp - lut->temp_min) * lut->temp_inv_step;
+    uint32_t offset = uncomp_press - lut->raw_min;
+
+    // Escrito en positivo para que una temperatura NaN también salga por aquí antes de
+    // convertirla a entero; por debajo de raw_min el desplazamiento da la vuelta
+    if (!(x >= 0.0f && x <= lut->temp_span) || offset > lut->raw_span)
+    {
+        return Compensate_Pressure_Float(&lut->coeff, uncomp_press, temp);
+    }
+
+    // El último nodo se interpola desde la celda anterior
+    uint32_t row = (uint32_t)x;
+    uint32_t col = offset >> lut->raw_shift;
+    row -= row == (uint32_t)lut->n_temp - 1;
+    col -= col == (uint32_t)lut->n_press - 1;
+    float fx = x - row;
+    float fy = (offset - (col << lut->raw_shift)) * lut->raw_inv_step;
+
+    const float *low = &lut->table[row * lut->n_press + col];
+    const float *high = low + lut->n_press;
+    float press_low = low[0] + fy * (low[1] - low[0]);
+    float press_high = high[0] + fy * (high[1] - high[0]);
+
+    return press_low + fx * (press_high - press_low);
+}
+
+/**
+ * @brief Memoria ocupada por la tabla
+ *
+ * @param lut : tabla
+ * @return uint32_t bytes, estructura y valores
+ */
+uint32_t Comp_LUT_Memory(const struct CompLut *lut)
+{
+    return sizeof(struct CompLut) + (uint32_t)lut->n_temp * lut->n_press * sizeof(float);
+}
+
+/**
+ * @brief Error de interpolación frente al polinomio en float
+ *
+ * @param lut : tabla
+ * @param max_error : parámetro de salida (Pa)
+ * @param rms_error : parámetro de salida (Pa)
+ */
+void Comp_LUT_Error(const struct CompLut *lut, float *max_error, float *rms_error)
+{
+    double sum_error2 = 0;
+    float max = 0;
+
+    for (uint16_t row = 0; row + 1 < lut->n_temp; row++)
+    {
+        float temp = lut->temp_min + (row + 0.5f) * lut->temp_step;
+        for (uint16_t col = 0; col + 1 < lut->n_press; col++)
+        {
+            uint32_t raw = lut->raw_min + ((uint32_t)col << lut->raw_shift) + ((1u << lut->raw_shift) >> 1);
+            float error = fabsf(Comp_LUT_Pressure(lut, raw, temp) - Compensate_Pressure_Float(&lut->coeff, raw, temp));
+            sum_error2 += (double)error * error;
+            max = error > max ? error : max;
+        }
+    }
+
+    *max_error = max;
+    *rms_error = sqrt(sum_error2 / ((uint32_t)(lut->n_temp - 1) * (lut->n_press - 1)));
+}
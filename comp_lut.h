@@ -0,0 +1,98 @@
+#pragma once
+
+#include "def.h"
+#include "stdbool.h"
+
+/*
+ * Tabla 2-D de presión compensada sobre (temperatura, presión sin compensar), calculada
+ * a partir de los coeficientes de cada sensor. Sustituye el polinomio por una
+ * interpolación bilineal. Init_Comp_LUT calcula la tabla entera (n_temp * n_press
+ * evaluaciones del polinomio); después sólo se lee, así que puede usarse desde varias
+ * tareas.
+ *
+ * El paso entre columnas es una potencia de 2 de la lectura sin compensar: la columna
+ * sale con un desplazamiento y la muestra cuesta la temperatura, dos índices y tres
+ * interpolaciones lineales. Fuera de la rejilla, o con temperatura no finita, se usa
+ * el polinomio en float.
+ */
+
+#define COMP_LUT_MIN_POINTS 2
+
+typedef enum
+{
+    COMP_LUT_FAILED = 0,
+    COMP_LUT_SUCCESS
+} CompLutEnum_t;
+
+/*! Rango y tamaño de la rejilla */
+struct CompLutConfig
+{
+    float temp_min;   // ºC
+    float temp_max;   // ºC
+    float press_min;  // Pa
+    float press_max;  // Pa
+    uint16_t n_temp;  // Filas de temperatura
+    uint16_t n_press; // Columnas de presión sin compensar (como máximo; ver Init_Comp_LUT)
+};
+
+/*! Tabla de un sensor. El búfer de valores lo aporta quien la usa */
+struct CompLut
+{
+    struct DataCoefficients coeff;
+    float temp_min;
+    float temp_step;
+    float temp_inv_step;
+    float temp_span;    // temp_max - temp_min en pasos, (n_temp - 1)
+    uint32_t raw_min;   // Presión sin compensar de la primera columna
+    uint32_t raw_span;  // Lecturas cubiertas desde raw_min, (n_press - 1) << raw_shift
+    uint8_t raw_shift;  // Paso entre columnas 2^raw_shift: los nodos caen en lecturas exactas
+    float raw_inv_step;
+    uint16_t n_temp;
+    uint16_t n_press;
+    float *table;       // n_temp * n_press valores en Pa, por filas de temperatura
+};
+
+/**
+ * @brief Preparación y cálculo de la tabla completa
+ *
+ * Con el paso redondeado a potencia de 2 puede bastar con menos columnas que
+ * config->n_press para cubrir el rango; lut->n_press queda con las usadas.
+ *
+ * @param lut : tabla
+ * @param coeff : coeficientes del sensor
+ * @param config : rango y tamaño de la rejilla
+ * @param table : búfer de valores
+ * @param table_len : capacidad del búfer en valores
+ * @return CompLutEnum_t error/success
+ */
+CompLutEnum_t Init_Comp_LUT(struct CompLut *lut, const struct DataCoefficients *coeff,
+                            const struct CompLutConfig *config, float *table, uint32_t table_len);
+
+/**
+ * @brief Presión compensada por interpolación bilineal
+ *
+ * @param lut : tabla
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return float presión (Pa)
+ */
+float Comp_LUT_Pressure(const struct CompLut *lut, uint32_t uncomp_press, float temp);
+
+/**
+ * @brief Memoria ocupada por la tabla
+ *
+ * @param lut : tabla
+ * @return uint32_t bytes, estructura y valores
+ */
+uint32_t Comp_LUT_Memory(const struct CompLut *lut);
+
+/**
+ * @brief Error de interpolación frente al polinomio en float
+ *
+ * Evalúa el centro de cada celda, donde el error bilineal es mayor.
+ *
+ * @param lut : tabla
+ * @param max_error : parámetro de salida (Pa)
+ * @param rms_error : parámetro de salida (Pa)
+ */
+void Comp_LUT_Error(const struct CompLut *lut, float *max_error, float *rms_error);
@@ -0,0 +1,190 @@
+#include "compensation.h"
+#include "math.h"
+
+/**
+ * @brief Cálculo de los coeficientes en float a partir de los registros NVM
+ *
+ * @param reg : datos de calibración
+ * @param coeff : parámetro de salida
+ */
+void Calc_Coefficients(const struct RegCalibData *reg, struct DataCoefficients *coeff)
+{
+    struct DataCoefficientsDouble coeff_double;
+
+    // Se calculan en double y se redondean una sola vez a float
+    Calc_Coefficients_Double(reg, &coeff_double);
+    coeff->nvm_t1 = coeff_double.nvm_t1;
+    coeff->nvm_t2 = coeff_double.nvm_t2;
+    coeff->nvm_t3 = coeff_double.nvm_t3;
+    coeff->nvm_p1 = coeff_double.nvm_p1;
+    coeff->nvm_p2 = coeff_double.nvm_p2;
+    coeff->nvm_p3 = coeff_double.nvm_p3;
+    coeff->nvm_p4 = coeff_double.nvm_p4;
+    coeff->nvm_p5 = coeff_double.nvm_p5;
+    coeff->nvm_p6 = coeff_double.nvm_p6;
+    coeff->nvm_p7 = coeff_double.nvm_p7;
+    coeff->nvm_p8 = coeff_double.nvm_p8;
+    coeff->nvm_p9 = coeff_double.nvm_p9;
+    coeff->nvm_p10 = coeff_double.nvm_p10;
+    coeff->nvm_p11 = coeff_double.nvm_p11;
+}
+
+/**
+ * @brief Cálculo de los coeficientes en double a partir de los registros NVM
+ *
+ * @param reg : datos de calibración
+ * @param coeff : parámetro de salida
+ */
+void Calc_Coefficients_Double(const struct RegCalibData *reg, struct DataCoefficientsDouble *coeff)
+{
+    // Escalados de la hoja de datos como potencias de 2 exactas, sin pow()
+    coeff->nvm_t1 = ldexp(reg->nvm_par_t1, 8);
+    coeff->nvm_t2 = ldexp(reg->nvm_par_t2, -30);
+    coeff->nvm_t3 = ldexp(reg->nvm_par_t3, -48);
+    coeff->nvm_p1 = ldexp(reg->nvm_par_p1 - 16384.0, -20);
+    coeff->nvm_p2 = ldexp(reg->nvm_par_p2 - 16384.0, -29);
+    coeff->nvm_p3 = ldexp(reg->nvm_par_p3, -32);
+    coeff->nvm_p4 = ldexp(reg->nvm_par_p4, -37);
+    coeff->nvm_p5 = ldexp(reg->nvm_par_p5, 3);
+    coeff->nvm_p6 = ldexp(reg->nvm_par_p6, -6);
+    coeff->nvm_p7 = ldexp(reg->nvm_par_p7, -8);
+    coeff->nvm_p8 = ldexp(reg->nvm_par_p8, -15);
+    coeff->nvm_p9 = ldexp(reg->nvm_par_p9, -48);
+    coeff->nvm_p10 = ldexp(reg->nvm_par_p10, -48);
+    coeff->nvm_p11 = ldexp(reg->nvm_par_p11, -65);
+}
+
+/**
+ * @brief Temperatura de referencia en double
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_temp : lectura sin compensar
+ * @return double temperatura (ºC)
+ */
+double Compensate_Temperature_Double(const struct DataCoefficientsDouble *coeff, uint32_t uncomp_temp)
+{
+    double partial_data1 = (double)uncomp_temp - coeff->nvm_t1;
+    double partial_data2 = partial_data1 * coeff->nvm_t2;
+
+    return partial_data2 + (partial_data1 * partial_data1) * coeff->nvm_t3;
+}
+
+/**
+ * @brief Presión de referencia en double
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return double presión (Pa)
+ */
+double Compensate_Pressure_Double(const struct DataCoefficientsDouble *coeff, uint32_t uncomp_press, double temp)
+{
+    double press = (double)uncomp_press;
+    double temp2 = temp * temp;
+    double temp3 = temp2 * temp;
+
+    double partial_out1 = coeff->nvm_p5 + coeff->nvm_p6 * temp + coeff->nvm_p7 * temp2 + coeff->nvm_p8 * temp3;
+    double partial_out2 = press * (coeff->nvm_p1 + coeff->nvm_p2 * temp + coeff->nvm_p3 * temp2 + coeff->nvm_p4 * temp3);
+    double partial_data4 = press * press * (coeff->nvm_p9 + coeff->nvm_p10 * temp) + press * press * press * coeff->nvm_p11;
+
+    return partial_out1 + partial_out2 + partial_data4;
+}
+
+/**
+ * @brief Temperatura en float
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_temp : lectura sin compensar
+ * @return float temperatura (ºC)
+ */
+float Compensate_Temperature_Float(const struct DataCoefficients *coeff, uint32_t uncomp_temp)
+{
+    float partial_data1 = (float)uncomp_temp - coeff->nvm_t1;
+
+    return partial_data1 * (coeff->nvm_t2 + partial_data1 * coeff->nvm_t3);
+}
+
+/**
+ * @brief Presión en float, polinomios evaluados por Horner
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return float presión (Pa)
+ */
+float Compensate_Pressure_Float(const struct DataCoefficients *coeff, uint32_t uncomp_press, float temp)
+{
+    float press = (float)uncomp_press;
+
+    float partial_out1 = coeff->nvm_p5 + temp * (coeff->nvm_p6 + temp * (coeff->nvm_p7 + temp * coeff->nvm_p8));
+    float partial_out2 = press * (coeff->nvm_p1 + temp * (coeff->nvm_p2 + temp * (coeff->nvm_p3 + temp * coeff->nvm_p4)));
+    float partial_data4 = press * press * (coeff->nvm_p9 + coeff->nvm_p10 * temp + press * coeff->nvm_p11);
+
+    return partial_out1 + partial_out2 + partial_data4;
+}
+
+/**
+ * @brief Temperatura en punto fijo
+ *
+ * @param reg : datos de calibración
+ * @param uncomp_temp : lectura sin compensar
+ * @return int64_t temperatura linealizada, ºC * 2^16
+ */
+int64_t Compensate_Temperature_Fixed(const struct RegCalibData *reg, uint32_t uncomp_temp)
+{
+    int64_t partial_data1 = (int64_t)uncomp_temp - (int64_t)256 * reg->nvm_par_t1;
+    int64_t partial_data2 = (int64_t)reg->nvm_par_t2 * partial_data1;
+    int64_t partial_data3 = partial_data1 * partial_data1 * reg->nvm_par_t3;
+
+    return (partial_data2 * 262144 + partial_data3) / 4294967296LL;
+}
+
+/**
+ * @brief Presión en punto fijo
+ *
+ * @param reg : datos de calibración
+ * @param uncomp_press : lectura sin compensar
+ * @param t_lin : temperatura linealizada, ºC * 2^16
+ * @return uint64_t presión en centésimas de Pa
+ */
+uint64_t Compensate_Pressure_Fixed(const struct RegCalibData *reg, uint32_t uncomp_press, int64_t t_lin)
+{
+    int64_t press = uncomp_press;
+    int64_t partial_data1;
+    int64_t partial_data2;
+    int64_t partial_data3;
+    int64_t partial_data4;
+    int64_t partial_data5;
+    int64_t partial_data6;
+    int64_t offset;
+    int64_t sensitivity;
+
+    // Desplazamiento: Pa * 2^44
+    partial_data1 = t_lin * t_lin;
+    partial_data2 = partial_data1 / 64;
+    partial_data3 = (partial_data2 * t_lin) / 256;
+    partial_data4 = (reg->nvm_par_p8 * partial_data3) / 32;
+    partial_data5 = (reg->nvm_par_p7 * partial_data1) * 16;
+    partial_data6 = (reg->nvm_par_p6 * t_lin) * 4194304;
+    offset = (int64_t)reg->nvm_par_p5 * 140737488355328LL + partial_data4 + partial_data5 + partial_data6;
+
+    // Sensibilidad: 2^66
+    partial_data2 = (reg->nvm_par_p4 * partial_data3) / 32;
+    partial_data4 = (reg->nvm_par_p3 * partial_data1) * 4;
+    partial_data5 = ((int64_t)reg->nvm_par_p2 - 16384) * t_lin * 2097152;
+    sensitivity = ((int64_t)reg->nvm_par_p1 - 16384) * 70368744177664LL + partial_data2 + partial_data4 + partial_data5;
+
+    // Términos de primer, segundo y tercer orden: Pa * 2^42
+    partial_data1 = (sensitivity / 16777216) * press;
+    partial_data2 = reg->nvm_par_p10 * t_lin;
+    partial_data3 = partial_data2 + 65536 * (int64_t)reg->nvm_par_p9;
+    partial_data4 = (partial_data3 * press) / 8192;
+    partial_data5 = (press * (partial_data4 / 10)) / 512;
+    partial_data5 = partial_data5 * 10;
+    partial_data6 = press * press;
+    partial_data2 = (reg->nvm_par_p11 * partial_data6) / 65536;
+    partial_data3 = (partial_data2 * press) / 128;
+    partial_data4 = offset / 4 + partial_data1 + partial_data5 + partial_data3;
+
+    return ((uint64_t)partial_data4 * 25) / 1099511627776ULL;
+}
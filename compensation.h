@@ -0,0 +1,118 @@
+#pragma once
+
+#include "def.h"
+
+/*
+ * Compensación de temperatura y presión, sin dependencias del bus ni de Arduino.
+ *
+ * Error frente a la referencia en double (tools/compensation_sweep.cpp, barrido de
+ * -40 a 85 ºC y 300-1250 hPa con una calibración típica):
+ *   COMP_FLOAT : máx. ~0.025 Pa, RMS ~0.006 Pa
+ *   COMP_FIXED : máx. ~0.015 Pa, RMS ~0.006 Pa (resolución de salida 0.01 Pa)
+ *   COMP_LUT   : según la rejilla, p. ej. 32x64 (7 KB) máx. ~0.62 Pa, 64x128 (28 KB) ~0.16 Pa
+ * En el ESP32 la FPU es de simple precisión: el double se emula por software y es
+ * el modo más lento; el coste en el host no sirve para comparar. Aun así, en un x86
+ * con FMA COMP_LUT tarda 1,3-1,7 veces lo que COMP_FLOAT: la tabla sólo tiene sentido
+ * donde el float es caro (núcleos sin FPU) y hay que medirla allí antes de elegirla.
+ */
+
+/*! Precisión de la compensación */
+typedef enum
+{
+    COMP_DOUBLE = 0, // Referencia, fórmulas de la hoja de datos en double
+    COMP_FLOAT,      // Float con coeficientes precalculados y Horner, sin pow()
+    COMP_FIXED,      // Enteros de 64 bits, sin coma flotante
+    COMP_LUT         // Tabla 2-D por sensor (comp_lut.h), presión interpolada
+} CompensationMode_t;
+
+/*! Coeficientes de calibración en double para la referencia */
+struct DataCoefficientsDouble
+{
+    double nvm_t1;
+    double nvm_t2;
+    double nvm_t3;
+    double nvm_p1;
+    double nvm_p2;
+    double nvm_p3;
+    double nvm_p4;
+    double nvm_p5;
+    double nvm_p6;
+    double nvm_p7;
+    double nvm_p8;
+    double nvm_p9;
+    double nvm_p10;
+    double nvm_p11;
+};
+
+/**
+ * @brief Cálculo de los coeficientes en float a partir de los registros NVM
+ *
+ * @param reg : datos de calibración
+ * @param coeff : parámetro de salida
+ */
+void Calc_Coefficients(const struct RegCalibData *reg, struct DataCoefficients *coeff);
+
+/**
+ * @brief Cálculo de los coeficientes en double a partir de los registros NVM
+ *
+ * @param reg : datos de calibración
+ * @param coeff : parámetro de salida
+ */
+void Calc_Coefficients_Double(const struct RegCalibData *reg, struct DataCoefficientsDouble *coeff);
+
+/**
+ * @brief Temperatura de referencia en double
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_temp : lectura sin compensar
+ * @return double temperatura (ºC)
+ */
+double Compensate_Temperature_Double(const struct DataCoefficientsDouble *coeff, uint32_t uncomp_temp);
+
+/**
+ * @brief Presión de referencia en double
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return double presión (Pa)
+ */
+double Compensate_Pressure_Double(const struct DataCoefficientsDouble *coeff, uint32_t uncomp_press, double temp);
+
+/**
+ * @brief Temperatura en float
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_temp : lectura sin compensar
+ * @return float temperatura (ºC)
+ */
+float Compensate_Temperature_Float(const struct DataCoefficients *coeff, uint32_t uncomp_temp);
+
+/**
+ * @brief Presión en float, polinomios evaluados por Horner
+ *
+ * @param coeff : coeficientes
+ * @param uncomp_press : lectura sin compensar
+ * @param temp : temperatura compensada (ºC)
+ * @return float presión (Pa)
+ */
+float Compensate_Pressure_Float(const struct DataCoefficients *coeff, uint32_t uncomp_press, float temp);
+
+/**
+ * @brief Temperatura en punto fijo
+ *
+ * @param reg : datos de calibración
+ * @param uncomp_temp : lectura sin compensar
+ * @return int64_t temperatura linealizada, ºC * 2^16
+ */
+int64_t Compensate_Temperature_Fixed(const struct RegCalibData *reg, uint32_t uncomp_temp);
+
+/**
+ * @brief Presión en punto fijo
+ *
+ * @param reg : datos de calibración
+ * @param uncomp_press : lectura sin compensar
+ * @param t_lin : temperatura linealizada, ºC * 2^16
+ * @return uint64_t presión en centésimas de Pa
+ */
+uint64_t Compensate_Pressure_Fixed(const struct RegCalibData *reg, uint32_t uncomp_press, int64_t t_lin);
@@ -1,3 +1,4 @@
+#pragma once
 
 #include "stdint.h"
 #include "stdio.h"
@@ -5,12 +6,57 @@
 #define SDA_I2C GPIO_NUM_13
 #define SCL_I2C GPIO_NUM_16
 
+// Definimos pines SPI
+#define SCK_SPI GPIO_NUM_18
+#define MISO_SPI GPIO_NUM_19
+#define MOSI_SPI GPIO_NUM_23
+#define CS_SPI GPIO_NUM_5
+
 // Definimos direccion I2C
 #define ADDR_I2C                0x77 // Registro i2c
+#define ADDR_I2C_ALT            0x76 // Dirección con SDO a GND, para un segundo sensor en el bus
+
+// Identificación del chip
+#define REG_CHIP_ID             0x00
+#define CHIP_ID                 0x50
 
 // Registros del datos
 #define REG_TEMP                0x07 // Registro temperatura
 #define REG_PRESS               0x04 // Registro presion
+#define REG_SENSORTIME          0x0C // Registro del reloj interno (24 bits)
+#define REG_STATUS              0x03 // Registro de estado
+#define STATUS_DRDY_PRESS       5    // Bit de presión disponible
+#define STATUS_DRDY_TEMP        6    // Bit de temperatura disponible
+
+// Registros de diagnóstico (se borran al leerlos)
+#define REG_ERR                 0x02 // Errores del sensor
+#define ERR_FATAL               0    // Error fatal, requiere reinicio
+#define ERR_CMD                 1    // Comando fallido
+#define ERR_CONF                2    // Configuración incoherente (OSR frente a ODR)
+#define REG_EVENT               0x10 // Eventos del sensor
+#define EVENT_POR_DETECTED      0    // Arranque tras alimentación o reinicio: configuración perdida
+
+// Registros de la FIFO
+#define REG_FIFO_LENGTH         0x12 // Bytes en la FIFO (9 bits)
+#define REG_FIFO_DATA           0x14 // Datos de la FIFO, la dirección no avanza en ráfaga
+#define REG_FIFO_WTM            0x15 // Nivel de aviso (9 bits)
+#define REG_FIFO_CONFIG_1       0x17 // Habilitación de la FIFO y de sus datos
+#define REG_FIFO_CONFIG_2       0x18 // Submuestreo y selección de datos
+#define REG_INT_STATUS          0x11 // Estado de las interrupciones
+#define REG_INT_CTRL            0x19 // Control de las interrupciones
+
+// Bits de REG_INT_CTRL
+#define INT_CTRL_OD             0 // Salida en drenador abierto
+#define INT_CTRL_LEVEL          1 // Activa a nivel alto
+#define INT_CTRL_LATCH          2 // Pin y estado retenidos hasta leer REG_INT_STATUS
+#define INT_CTRL_FWTM_EN        3 // Interrupción por nivel de aviso de la FIFO
+#define INT_CTRL_FFULL_EN       4 // Interrupción por FIFO llena
+#define INT_CTRL_DRDY_EN        6 // Interrupción por dato disponible
+
+// Bits de REG_INT_STATUS (se borran al leerlo)
+#define INT_STATUS_FWTM         0
+#define INT_STATUS_FFULL        1
+#define INT_STATUS_DRDY         3
 
 // Registros de los datos de calibración
 #define NVM_PAR_T1              0x31
@@ -33,6 +79,22 @@
 #define REG_OSR                 0x1C // Registro del oversampling
 #define REG_CONFIG              0x1F // Registro del filtro
 #define REG_ODR                 0x1D // Registro del output data
+#define REG_CMD                 0x7E // Registro de comandos
+
+// Comandos
+#define CMD_SOFT_RESET          0xB6 // Reinicio por software
+#define CMD_FIFO_FLUSH          0xB0 // Vaciado de la FIFO
+
+// Modos de funcionamiento (bits 4-5 de REG_PWR_CNTRL)
+#define MODE_SLEEP              0x00
+#define MODE_FORCED             0x10
+#define MODE_NORMAL             0x30
+#define PWR_PRESS_EN            0x01
+#define PWR_TEMP_EN             0x02
+
+// Periodo de muestreo a ODR_200; cada paso de REG_ODR (bits 0-4) lo dobla
+#define ODR_BASE_PERIOD_US      5000
+#define ODR_SEL_MASK            0x1F
 
 /*! Datos de calibración */
 struct RegCalibData
@@ -73,9 +135,6 @@ struct DataCoefficients
     float nvm_p9;
     float nvm_p10;
     float nvm_p11;
-
-    float comp_temp;
-    
 };
 
 
@@ -152,6 +211,12 @@ typedef enum
     SET_ODR_SUCCESS,
     SET_ODR_FAILED,
     GET_ODR_SUCCESS,
-    GET_ODR_FAILED
+    GET_ODR_FAILED,
+    REINIT_SENSOR_SUCCESS,
+    REINIT_SENSOR_FAILED,
+    GET_SENSOR_TIME_SUCCESS,
+    GET_SENSOR_TIME_FAILED,
+    SAVE_CONFIG_SUCCESS,
+    SAVE_CONFIG_FAILED
 
 }SensorEnum_t;
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "events.h"
+#include "stddef.h"
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Medida de la velocidad de cambio por diferencias sobre el intervalo configurado
+ */
+static void Update_Rate(struct EventEngine *engine, float press, uint32_t time_us)
+{
+    if (!engine->has_ref)
+    {
+        engine->ref_press = press;
+        engine->ref_us = time_us;
+        engine->has_ref = true;
+        return;
+    }
+
+    // Un intervalo corto amplifica el ruido de la presión: se espera al completo
+    uint32_t elapsed = time_us - engine->ref_us;
+    if (elapsed >= engine->rate_window_us)
+    {
+        engine->rate = (press - engine->ref_press) * 1e6f / elapsed;
+        engine->has_rate = true;
+        engine->ref_press = press;
+        engine->ref_us = time_us;
+    }
+}
+
+/**
+ * @brief Estado de la condición de una regla: disparo, rearme o sin cambio
+ *
+ * @return 1 si se dispara, -1 si se rearma, 0 si no cambia
+ */
+static int8_t Check_Rule(const struct EventRule *rule, bool active, float press, float rate, bool has_rate)
+{
+    float value = press;
+    bool above = true;
+
+    switch (rule->kind)
+    {
+    case EVENT_PRESS_BELOW:
+        above = false;
+        break;
+    case EVENT_RATE_ABOVE:
+        value = rate;
+        break;
+    case EVENT_RATE_BELOW:
+        value = rate;
+        above = false;
+        break;
+    default:
+        break;
+    }
+    if ((rule->kind == EVENT_RATE_ABOVE || rule->kind == EVENT_RATE_BELOW) && !has_rate)
+    {
+        return 0;
+    }
+
+    if (!active)
+    {
+        return (above ? value > rule->threshold : value < rule->threshold) ? 1 : 0;
+    }
+    return (above ? value < rule->threshold - rule->hysteresis : value > rule->threshold + rule->hysteresis) ? -1 : 0;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Inicialización del motor
+ *
+ * @param engine : contexto
+ * @param rate_window_us : intervalo de medida de la velocidad (0 = EVENT_RATE_WINDOW_US)
+ */
+void Init_Event_Engine(struct EventEngine *engine, uint32_t rate_window_us)
+{
+    engine->n_rules = 0;
+    engine->rate_window_us = rate_window_us > 0 ? rate_window_us : EVENT_RATE_WINDOW_US;
+    engine->has_ref = false;
+    engine->has_rate = false;
+    engine->rate = 0.0f;
+    engine->evaluated = 0;
+    engine->fired = 0;
+}
+
+/**
+ * @brief Alta de una regla
+ *
+ * @param engine : contexto
+ * @param rule : regla
+ * @return EventEnum_t error si no caben más reglas o falta el callback
+ */
+EventEnum_t Event_Add_Rule(struct EventEngine *engine, const struct EventRule *rule)
+{
+    if (engine->n_rules >= EVENT_MAX_RULES || rule->callback == NULL || rule->hysteresis < 0.0f)
+    {
+        return EVENT_FAILED;
+    }
+    engine->rules[engine->n_rules] = *rule;
+    engine->active[engine->n_rules] = false;
+    engine->n_rules++;
+    return EVENT_SUCCESS;
+}
+
+/**
+ * @brief Evaluación de una muestra
+ *
+ * @param engine : contexto
+ * @param press : presión (Pa)
+ * @param time_us : instante de la muestra
+ * @return uint8_t reglas disparadas
+ */
+uint8_t Event_Process(struct EventEngine *engine, float press, uint32_t time_us)
+{
+    uint8_t fired = 0;
+
+    Update_Rate(engine, press, time_us);
+    engine->evaluated++;
+
+    for (uint8_t i = 0; i < engine->n_rules; i++)
+    {
+        int8_t change = Check_Rule(&engine->rules[i], engine->active[i], press, engine->rate, engine->has_rate);
+        if (change < 0)
+        {
+            engine->active[i] = false;
+        }
+        else if (change > 0)
+        {
+            struct EventInfo info = {i, engine->rules[i].kind, press, engine->rate, time_us};
+            engine->active[i] = true;
+            engine->fired++;
+            fired++;
+            engine->rules[i].callback(&info, engine->rules[i].user);
+        }
+    }
+    return fired;
+}
+
+/**
+ * @brief Evaluación de un lote, p. ej. una descarga de la FIFO
+ *
+ * @param engine : contexto
+ * @param press : presiones (Pa), de la más antigua a la más reciente
+ * @param count : número de muestras
+ * @param time_us : instante de la última muestra
+ * @param period_us : separación entre muestras
+ * @return uint16_t reglas disparadas en todo el lote
+ */
+uint16_t Event_Process_Batch(struct EventEngine *engine, const float *press, uint16_t count, uint32_t time_us,
+                             uint32_t period_us)
+{
+    uint16_t fired = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        fired += Event_Process(engine, press[i], time_us - (uint32_t)(count - 1 - i) * period_us);
+    }
+    return fired;
+}
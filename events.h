@@ -0,0 +1,111 @@
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/*
+ * Motor de eventos sobre la presión compensada: umbrales y velocidad de cambio con
+ * histéresis. Se evalúa en cada muestra o lote y sólo llama al callback de una regla
+ * cuando su condición se dispara; no vuelve a dispararse hasta que la magnitud
+ * retrocede más allá de la histéresis.
+ */
+
+#ifndef EVENT_MAX_RULES
+#define EVENT_MAX_RULES         8
+#endif
+
+// Intervalo por defecto para medir la velocidad de cambio
+#define EVENT_RATE_WINDOW_US    1000000
+
+typedef enum
+{
+    EVENT_FAILED = 0,
+    EVENT_SUCCESS
+} EventEnum_t;
+
+/*! Condición de una regla */
+typedef enum
+{
+    EVENT_PRESS_ABOVE = 0, // Presión > umbral (Pa)
+    EVENT_PRESS_BELOW,     // Presión < umbral (Pa)
+    EVENT_RATE_ABOVE,      // Velocidad > umbral (Pa/s), p. ej. bajada de planta
+    EVENT_RATE_BELOW       // Velocidad < umbral (Pa/s), p. ej. -30 para una subida o una caída
+} EventKind_t;
+
+/*! Datos del disparo que recibe el callback */
+struct EventInfo
+{
+    uint8_t rule;     // Índice de la regla
+    EventKind_t kind;
+    float press;      // Pa
+    float rate;       // Pa/s
+    uint32_t time_us;
+};
+
+typedef void (*EventCallback_t)(const struct EventInfo *info, void *user);
+
+/*! Regla */
+struct EventRule
+{
+    EventKind_t kind;
+    float threshold;  // Pa o Pa/s según la condición
+    float hysteresis; // Retroceso necesario para rearmar la regla, mismas unidades
+    EventCallback_t callback;
+    void *user;
+};
+
+/*! Contexto del motor, uno por sensor */
+struct EventEngine
+{
+    struct EventRule rules[EVENT_MAX_RULES];
+    bool active[EVENT_MAX_RULES]; // Condición disparada y aún sin rearmar
+    uint8_t n_rules;
+    uint32_t rate_window_us;
+    float ref_press;              // Muestra de referencia para la velocidad
+    uint32_t ref_us;
+    bool has_ref;
+    float rate;                   // Última velocidad medida (Pa/s)
+    bool has_rate;
+    uint32_t evaluated;           // Muestras evaluadas
+    uint32_t fired;               // Disparos
+};
+
+/**
+ * @brief Inicialización del motor
+ *
+ * @param engine : contexto
+ * @param rate_window_us : intervalo de medida de la velocidad (0 = EVENT_RATE_WINDOW_US)
+ */
+void Init_Event_Engine(struct EventEngine *engine, uint32_t rate_window_us);
+
+/**
+ * @brief Alta de una regla
+ *
+ * @param engine : contexto
+ * @param rule : regla
+ * @return EventEnum_t error si no caben más reglas o falta el callback
+ */
+EventEnum_t Event_Add_Rule(struct EventEngine *engine, const struct EventRule *rule);
+
+/**
+ * @brief Evaluación de una muestra
+ *
+ * @param engine : contexto
+ * @param press : presión (Pa)
+ * @param time_us : instante de la muestra
+ * @return uint8_t reglas disparadas
+ */
+uint8_t Event_Process(struct EventEngine *engine, float press, uint32_t time_us);
+
+/**
+ * @brief Evaluación de un lote, p. ej. una descarga de la FIFO
+ *
+ * @param engine : contexto
+ * @param press : presiones (Pa), de la más antigua a la más reciente
+ * @param count : número de muestras
+ * @param time_us : instante de la última muestra
+ * @param period_us : separación entre muestras
+ * @return uint16_t reglas disparadas en todo el lote
+ */
+uint16_t Event_Process_Batch(struct EventEngine *engine, const float *press, uint16_t count, uint32_t time_us,
+                             uint32_t period_us);
@@ -0,0 +1,259 @@
+#include "fifo.h"
+#include "transport.h"
+#include "sensor.h"
+
+#define FIFO_MODE_EN            0x01
+#define FIFO_TIME_EN            0x04
+#define FIFO_PRESS_EN           0x08
+#define FIFO_TEMP_EN            0x10
+#define FIFO_DATA_FILTERED      0x08 // Datos filtrados por el IIR en REG_FIFO_CONFIG_2
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+static uint32_t Get_U24(const uint8_t *buf)
+{
+    return ((uint32_t)buf[2] << 16) | ((uint32_t)buf[1] << 8) | buf[0];
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Configuración de la FIFO
+ *
+ * @param press_en : guardar presión
+ * @param temp_en : guardar temperatura
+ * @param time_en : añadir sensortime al vaciarla
+ * @param watermark : nivel de aviso en bytes (0 lo deja sin cambiar)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Set_FIFO_Config(bool press_en, bool temp_en, bool time_en, uint16_t watermark)
+{
+    uint8_t config = FIFO_MODE_EN;
+    if (press_en)
+    {
+        config |= FIFO_PRESS_EN;
+    }
+    if (temp_en)
+    {
+        config |= FIFO_TEMP_EN;
+    }
+    if (time_en)
+    {
+        config |= FIFO_TIME_EN;
+    }
+
+    if (watermark > 0)
+    {
+        if (Transport_Write(REG_FIFO_WTM, watermark & 0xFF) != TRANSPORT_SUCCESS ||
+            Transport_Write(REG_FIFO_WTM + 1, (watermark >> 8) & 0x01) != TRANSPORT_SUCCESS)
+        {
+            return FIFO_FAILED;
+        }
+    }
+
+    if (Transport_Write(REG_FIFO_CONFIG_2, FIFO_DATA_FILTERED) != TRANSPORT_SUCCESS ||
+        Transport_Write(REG_FIFO_CONFIG_1, config) != TRANSPORT_SUCCESS)
+    {
+        return FIFO_FAILED;
+    }
+    // Copia para que un reinicio del sensor la restaure
+    return Save_BMP_Config() == SAVE_CONFIG_SUCCESS ? FIFO_SUCCESS : FIFO_FAILED;
+}
+
+/**
+ * @brief Bytes pendientes en la FIFO
+ *
+ * @param len : parámetro de salida
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Get_FIFO_Length(uint16_t *len)
+{
+    uint16_t data;
+    FifoEnum_t error = FIFO_FAILED;
+    if (Transport_Read16(REG_FIFO_LENGTH, &data) == TRANSPORT_SUCCESS)
+    {
+        *len = data & 0x01FF;
+        error = FIFO_SUCCESS;
+    }
+    return error;
+}
+
+/**
+ * @brief Lectura en ráfaga de la FIFO
+ *
+ * @param buf : buffer de salida
+ * @param len : bytes a leer
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Read_FIFO(uint8_t *buf, uint16_t len)
+{
+    if (len == 0 || len > FIFO_MAX_BYTES)
+    {
+        return FIFO_FAILED;
+    }
+    return Transport_Read(REG_FIFO_DATA, buf, len) == TRANSPORT_SUCCESS ? FIFO_SUCCESS : FIFO_FAILED;
+}
+
+/**
+ * @brief Vaciado de la FIFO sin leerla
+ *
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Flush_FIFO()
+{
+    return Transport_Write(REG_CMD, CMD_FIFO_FLUSH) == TRANSPORT_SUCCESS ? FIFO_SUCCESS : FIFO_FAILED;
+}
+
+/**
+ * @brief Separación de las tramas leídas de la FIFO
+ *
+ * @param buf : bytes leídos
+ * @param len : número de bytes
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param sensor_time : sensortime si aparece la trama correspondiente (puede ser NULL)
+ * @return uint16_t número de muestras
+ */
+uint16_t Parse_FIFO(const uint8_t *buf, uint16_t len, struct FifoSample *samples, uint16_t max_samples,
+                    uint32_t *sensor_time)
+{
+    uint16_t idx = 0;
+    uint16_t count = 0;
+
+    while (idx < len && count < max_samples)
+    {
+        uint8_t header = buf[idx++];
+        uint16_t remaining = len - idx;
+
+        switch (header)
+        {
+        case FIFO_FRAME_PRESS_TEMP:
+            if (remaining < 6)
+            {
+                return count;
+            }
+            samples[count].uncomp_temp = Get_U24(&buf[idx]);
+            samples[count].uncomp_press = Get_U24(&buf[idx + 3]);
+            samples[count].flags = FIFO_SAMPLE_PRESS | FIFO_SAMPLE_TEMP;
+            count++;
+            idx += 6;
+            break;
+        case FIFO_FRAME_TEMP:
+            if (remaining < 3)
+            {
+                return count;
+            }
+            samples[count].uncomp_temp = Get_U24(&buf[idx]);
+            samples[count].uncomp_press = 0;
+            samples[count].flags = FIFO_SAMPLE_TEMP;
+            count++;
+            idx += 3;
+            break;
+        case FIFO_FRAME_PRESS:
+            if (remaining < 3)
+            {
+                return count;
+            }
+            samples[count].uncomp_press = Get_U24(&buf[idx]);
+            samples[count].uncomp_temp = 0;
+            samples[count].flags = FIFO_SAMPLE_PRESS;
+            count++;
+            idx += 3;
+            break;
+        case FIFO_FRAME_TIME:
+            if (remaining < 3)
+            {
+                return count;
+            }
+            if (sensor_time != NULL)
+            {
+                *sensor_time = Get_U24(&buf[idx]);
+            }
+            idx += 3;
+            break;
+        case FIFO_FRAME_CONFIG_ERROR:
+        case FIFO_FRAME_CONFIG_CHG:
+            idx += 1;
+            break;
+        default:
+            // Trama vacía o cabecera desconocida: no hay más datos útiles
+            return count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Descarga completa de la FIFO: longitud, lectura y separación de tramas
+ *
+ * @param raw : buffer de trabajo de FIFO_MAX_BYTES
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param count : número de muestras
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Drain_FIFO(uint8_t *raw, struct FifoSample *samples, uint16_t max_samples, uint16_t *count)
+{
+    uint16_t len;
+
+    *count = 0;
+    if (Get_FIFO_Length(&len) != FIFO_SUCCESS)
+    {
+        return FIFO_FAILED;
+    }
+    if (len == 0)
+    {
+        return FIFO_SUCCESS;
+    }
+
+    // Se piden 4 bytes más para recoger la trama de sensortime que sigue a los datos
+    len += 4;
+    if (len > FIFO_MAX_BYTES)
+    {
+        len = FIFO_MAX_BYTES;
+    }
+    if (Read_FIFO(raw, len) != FIFO_SUCCESS)
+    {
+        return FIFO_FAILED;
+    }
+
+    *count = Parse_FIFO(raw, len, samples, max_samples, NULL);
+    return FIFO_SUCCESS;
+}
+
+/**
+ * @brief Configuración del pin de interrupción para avisar al llegar al nivel de aviso
+ *
+ * @param enable : interrupción por nivel de aviso
+ * @param active_high : pin activo a nivel alto (push-pull)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Set_FIFO_Interrupt(bool enable, bool active_high)
+{
+    // Sin retención: el pin baja solo en cuanto la descarga deja la FIFO bajo el nivel de aviso
+    uint8_t int_ctrl = 0;
+    if (enable)
+    {
+        int_ctrl |= 1 << INT_CTRL_FWTM_EN;
+    }
+    if (active_high)
+    {
+        int_ctrl |= 1 << INT_CTRL_LEVEL;
+    }
+    if (Transport_Write(REG_INT_CTRL, int_ctrl) != TRANSPORT_SUCCESS)
+    {
+        return FIFO_FAILED;
+    }
+    return Save_BMP_Config() == SAVE_CONFIG_SUCCESS ? FIFO_SUCCESS : FIFO_FAILED;
+}
+
+/**
+ * @brief Lectura y borrado del estado de las interrupciones
+ *
+ * @param status : parámetro de salida (bits INT_STATUS_*)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Get_Interrupt_Status(uint8_t *status)
+{
+    return Transport_Read8(REG_INT_STATUS, status) == TRANSPORT_SUCCESS ? FIFO_SUCCESS : FIFO_FAILED;
+}
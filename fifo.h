@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Arduino.h"
+#include "def.h"
+
+// Capacidad de la FIFO del BMP388 más los 4 bytes de la trama de sensortime
+#define FIFO_MAX_BYTES          516
+
+// Cabeceras de las tramas de la FIFO
+#define FIFO_FRAME_PRESS_TEMP   0x94 // Temperatura y presión (temperatura primero)
+#define FIFO_FRAME_TEMP         0x90
+#define FIFO_FRAME_PRESS        0x84
+#define FIFO_FRAME_TIME         0xA0 // Sensortime, sólo al vaciar la FIFO
+#define FIFO_FRAME_EMPTY        0x80
+#define FIFO_FRAME_CONFIG_ERROR 0x44
+#define FIFO_FRAME_CONFIG_CHG   0x48
+
+// Trama de temperatura y presión: cabecera y dos medidas de 3 bytes
+#define FIFO_FRAME_BYTES        7
+
+// Contenido de una muestra de la FIFO
+#define FIFO_SAMPLE_PRESS       0x01
+#define FIFO_SAMPLE_TEMP        0x02
+
+typedef enum
+{
+    FIFO_FAILED = 0,
+    FIFO_SUCCESS
+} FifoEnum_t;
+
+/*! Muestra sin compensar extraída de la FIFO */
+struct FifoSample
+{
+    uint32_t uncomp_press;
+    uint32_t uncomp_temp;
+    uint8_t flags; // FIFO_SAMPLE_PRESS | FIFO_SAMPLE_TEMP
+};
+
+/**
+ * @brief Configuración de la FIFO
+ *
+ * @param press_en : guardar presión
+ * @param temp_en : guardar temperatura
+ * @param time_en : añadir sensortime al vaciarla
+ * @param watermark : nivel de aviso en bytes (0 lo deja sin cambiar)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Set_FIFO_Config(bool press_en, bool temp_en, bool time_en, uint16_t watermark);
+
+/**
+ * @brief Bytes pendientes en la FIFO
+ *
+ * @param len : parámetro de salida
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Get_FIFO_Length(uint16_t *len);
+
+/**
+ * @brief Lectura en ráfaga de la FIFO
+ *
+ * @param buf : buffer de salida
+ * @param len : bytes a leer
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Read_FIFO(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief Vaciado de la FIFO sin leerla
+ *
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Flush_FIFO();
+
+/**
+ * @brief Separación de las tramas leídas de la FIFO
+ *
+ * @param buf : bytes leídos
+ * @param len : número de bytes
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param sensor_time : sensortime si aparece la trama correspondiente (puede ser NULL)
+ * @return uint16_t número de muestras
+ */
+uint16_t Parse_FIFO(const uint8_t *buf, uint16_t len, struct FifoSample *samples, uint16_t max_samples,
+                    uint32_t *sensor_time);
+
+/**
+ * @brief Descarga completa de la FIFO: longitud, lectura y separación de tramas
+ *
+ * @param raw : buffer de trabajo de FIFO_MAX_BYTES
+ * @param samples : muestras de salida
+ * @param max_samples : capacidad de samples
+ * @param count : número de muestras
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Drain_FIFO(uint8_t *raw, struct FifoSample *samples, uint16_t max_samples, uint16_t *count);
+
+/**
+ * @brief Configuración del pin de interrupción para avisar al llegar al nivel de aviso
+ *
+ * Con la FIFO y el nivel de aviso configurados, la aplicación puede dormir hasta el
+ * flanco del pin en lugar de sondear la FIFO.
+ *
+ * @param enable : interrupción por nivel de aviso
+ * @param active_high : pin activo a nivel alto (push-pull)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Set_FIFO_Interrupt(bool enable, bool active_high);
+
+/**
+ * @brief Lectura y borrado del estado de las interrupciones
+ *
+ * @param status : parámetro de salida (bits INT_STATUS_*)
+ * @return FifoEnum_t error/success
+ */
+FifoEnum_t Get_Interrupt_Status(uint8_t *status);
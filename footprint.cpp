@@ -0,0 +1,38 @@
+#include "footprint.h"
+#include "bus.h"
+#include "i2c.h"
+#include "i2c_idf.h"
+#include "spi.h"
+#include "sensor.h"
+#include "altitude.h"
+#include "pipeline.h"
+#include "async.h"
+#include "telemetry.h"
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Cálculo del informe
+ *
+ * @param footprint : parámetro de salida
+ */
+void Get_Footprint(struct Footprint *footprint)
+{
+    footprint->bus = Get_Bus_Footprint();
+    footprint->i2c = Get_I2C_Footprint();
+    footprint->i2c_idf = Get_I2C_IDF_Footprint();
+    footprint->spi = Get_SPI_Footprint();
+    footprint->sensor = Get_Sensor_Footprint();
+    footprint->altitude = Get_Altitude_Footprint();
+    footprint->pipeline = Get_Pipeline_Footprint();
+    footprint->total = footprint->bus + footprint->i2c + footprint->i2c_idf + footprint->spi + footprint->sensor +
+                       footprint->altitude + footprint->pipeline;
+
+    footprint->aggregator = sizeof(struct Aggregator);
+    footprint->comp_lut = sizeof(struct CompLut);
+    footprint->events = sizeof(struct EventEngine);
+    footprint->health = sizeof(struct HealthMonitor);
+    footprint->async =
+        sizeof(struct AsyncExecutor) + ASYNC_MAX_TASKS * sizeof(struct AsyncTask) + sizeof(struct AsyncSensor);
+    footprint->telemetry = sizeof(struct TelemetryEncoder);
+}
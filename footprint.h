@@ -0,0 +1,41 @@
+#pragma once
+
+#include "stdint.h"
+
+/*
+ * Informe de memoria: bytes estáticos de cada subsistema, fijados al enlazar, y tamaño
+ * de los contextos que aporta quien los usa (uno por sensor). Los tamaños se ajustan en
+ * compilación con RING_SIZE, PIPELINE_STACK_SIZE, PIPELINE_FIFO_SAMPLES, AGG_MAX_WINDOW,
+ * EVENT_MAX_RULES, ASYNC_MAX_TASKS y TELEMETRY_MAX_SAMPLES.
+ *
+ * Tras la inicialización el driver no reserva memoria dinámica. Quedan fuera del
+ * informe las reservas internas de Wire/SPIClass y del driver i2c_master al crear el bus.
+ */
+
+/*! Bytes por subsistema */
+struct Footprint
+{
+    // Estáticos
+    uint32_t bus;
+    uint32_t i2c;
+    uint32_t i2c_idf;
+    uint32_t spi;
+    uint32_t sensor;
+    uint32_t altitude;
+    uint32_t pipeline;
+    uint32_t total;
+    // Por instancia, reservados por quien los usa
+    uint32_t aggregator;
+    uint32_t comp_lut;  // Sin la tabla de valores, que depende de la rejilla
+    uint32_t events;
+    uint32_t health;
+    uint32_t async;     // Ejecutor lleno y un sensor
+    uint32_t telemetry; // Codificador; la trama decodificada sólo la usa el receptor
+};
+
+/**
+ * @brief Cálculo del informe
+ *
+ * @param footprint : parámetro de salida
+ */
+void Get_Footprint(struct Footprint *footprint);
@@ -0,0 +1,358 @@
+#include "health.h"
+#include "transport.h"
+#include "sensor.h"
+#include "bus.h"
+
+#define REG_RESERVED_1E         0x1E // Hueco entre REG_ODR y REG_CONFIG
+#define PWR_MODE_MASK           0x30
+#define PWR_EN_MASK             (PWR_PRESS_EN | PWR_TEMP_EN)
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Lectura de la configuración actual
+ */
+static bool Read_Config(uint8_t *config)
+{
+    return Transport_Read(HEALTH_SHADOW_FIRST, config, HEALTH_SHADOW_LEN) == TRANSPORT_SUCCESS;
+}
+
+/**
+ * @brief Lectura de ERR_REG, EVENT y la configuración, y comparación con la copia
+ *
+ * @param found : parámetro de salida, fallos encontrados (HealthFault_t)
+ * @param err : parámetro de salida, ERR_REG
+ * @return false si falla alguna lectura
+ */
+static bool Read_Diagnostics(const struct HealthMonitor *monitor, uint8_t *found, uint8_t *err)
+{
+    uint8_t event;
+    uint8_t config[HEALTH_SHADOW_LEN];
+
+    if (Transport_Read8(REG_ERR, err) != TRANSPORT_SUCCESS || Transport_Read8(REG_EVENT, &event) != TRANSPORT_SUCCESS ||
+        !Read_Config(config))
+    {
+        return false;
+    }
+
+    *found = HEALTH_FAULT_NONE;
+    if (*err & (1 << ERR_FATAL))
+    {
+        *found |= HEALTH_FAULT_FATAL;
+    }
+    if (event & (1 << EVENT_POR_DETECTED))
+    {
+        *found |= HEALTH_FAULT_POR;
+    }
+
+    for (uint8_t i = 0; i < HEALTH_SHADOW_LEN; i++)
+    {
+        uint8_t reg = HEALTH_SHADOW_FIRST + i;
+        if (reg == REG_RESERVED_1E)
+        {
+            continue;
+        }
+        if (reg == REG_PWR_CNTRL)
+        {
+            // En modo forzado el sensor vuelve solo a sleep: sólo cuenta el modo si es normal
+            uint8_t mask = (monitor->shadow[i] & PWR_MODE_MASK) == MODE_NORMAL ? PWR_MODE_MASK | PWR_EN_MASK : PWR_EN_MASK;
+            if ((config[i] ^ monitor->shadow[i]) & mask)
+            {
+                *found |= HEALTH_FAULT_MODE;
+            }
+        }
+        else if (config[i] != monitor->shadow[i])
+        {
+            *found |= HEALTH_FAULT_CONFIG;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reescritura de PWR_CTRL pasando por sleep: relanza las conversiones
+ *
+ * @return false si falla alguna escritura o no se puede tomar el bus
+ */
+static bool Restore_Mode(const struct HealthMonitor *monitor)
+{
+    uint8_t pwr = monitor->shadow[REG_PWR_CNTRL - HEALTH_SHADOW_FIRST];
+
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return false;
+    }
+    bool ok = Transport_Write(REG_PWR_CNTRL, pwr & PWR_EN_MASK) == TRANSPORT_SUCCESS &&
+              Transport_Write(REG_PWR_CNTRL, pwr) == TRANSPORT_SUCCESS;
+    Bus_Unlock();
+    return ok;
+}
+
+/**
+ * @brief Restauración de la configuración copiada; el modo se escribe el último
+ *
+ * @return false si falla alguna escritura o no se puede tomar el bus
+ */
+static bool Restore_Config(const struct HealthMonitor *monitor)
+{
+    uint8_t pwr = monitor->shadow[REG_PWR_CNTRL - HEALTH_SHADOW_FIRST];
+
+    // Toda la secuencia con el bus tomado: ninguna otra tarea lee a mitad de la restauración
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return false;
+    }
+
+    // OSR, ODR y filtro sólo se cambian con el sensor en sleep
+    bool ok = Transport_Write(REG_PWR_CNTRL, pwr & PWR_EN_MASK) == TRANSPORT_SUCCESS;
+    for (uint8_t i = 0; ok && i < HEALTH_SHADOW_LEN; i++)
+    {
+        uint8_t reg = HEALTH_SHADOW_FIRST + i;
+        if (reg != REG_RESERVED_1E && reg != REG_PWR_CNTRL)
+        {
+            ok = Transport_Write(reg, monitor->shadow[i]) == TRANSPORT_SUCCESS;
+        }
+    }
+    ok = ok && Transport_Write(REG_PWR_CNTRL, pwr) == TRANSPORT_SUCCESS;
+
+    Bus_Unlock();
+    return ok;
+}
+
+/**
+ * @brief Alta de fallos; el tiempo de recuperación cuenta desde el primero
+ */
+static void Open_Faults(struct HealthMonitor *monitor, uint8_t found)
+{
+    if (found == HEALTH_FAULT_NONE)
+    {
+        return;
+    }
+    if (monitor->faults == HEALTH_FAULT_NONE)
+    {
+        monitor->fault_us = micros();
+        monitor->attempts = 0;
+    }
+    monitor->faults |= found;
+}
+
+/**
+ * @brief Cierre de los fallos abiertos y registro del tiempo de recuperación
+ */
+static void Close_Faults(struct HealthMonitor *monitor)
+{
+    uint32_t elapsed = micros() - monitor->fault_us;
+
+    monitor->faults = HEALTH_FAULT_NONE;
+    monitor->attempts = 0;
+    monitor->stats.recoveries++;
+    monitor->stats.last_recover_us = elapsed;
+    monitor->stats.total_recover_us += elapsed;
+    if (elapsed > monitor->stats.max_recover_us)
+    {
+        monitor->stats.max_recover_us = elapsed;
+    }
+}
+
+/**
+ * @brief Recuperación de los fallos abiertos y verificación por registros
+ *
+ * La primera vez se aplica la medida mínima; si el fallo sigue abierto en la siguiente
+ * detección, o es un error fatal o del bus, se reinicia el sensor.
+ */
+static void Recover(struct HealthMonitor *monitor)
+{
+    bool full = monitor->attempts > 0 || (monitor->faults & (HEALTH_FAULT_FATAL | HEALTH_FAULT_BUS));
+
+    // Un intento cuyas escrituras fallan queda contado y deja el fallo abierto: el
+    // siguiente pasa al reinicio completo
+    bool restored;
+    monitor->attempts++;
+    monitor->repeats = 0;
+    if (full)
+    {
+        monitor->stats.full_reinits++;
+        // Nadie lee el sensor entre el reinicio y la restauración, con la configuración por defecto
+        restored = Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) == BUS_LOCK_SUCCESS;
+        if (restored)
+        {
+            restored = Reinit_BMP() == REINIT_SENSOR_SUCCESS && Restore_Config(monitor);
+            Bus_Unlock();
+        }
+    }
+    else
+    {
+        monitor->stats.targeted_reinits++;
+        if (monitor->faults & (HEALTH_FAULT_POR | HEALTH_FAULT_CONFIG))
+        {
+            restored = Restore_Config(monitor);
+        }
+        else
+        {
+            restored = Restore_Mode(monitor);
+        }
+    }
+    if (!restored)
+    {
+        return;
+    }
+
+    // El reinicio deja levantado por_detected: en la verificación no cuenta
+    uint8_t found;
+    uint8_t err;
+    if (!Read_Diagnostics(monitor, &found, &err) || (found & ~HEALTH_FAULT_POR) != HEALTH_FAULT_NONE)
+    {
+        return;
+    }
+    monitor->read_failures = 0;
+    monitor->faults &= HEALTH_FAULT_STUCK;
+    if (monitor->faults == HEALTH_FAULT_NONE)
+    {
+        Close_Faults(monitor);
+    }
+    // Un dato congelado se da por recuperado cuando cambia la siguiente conversión
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Inicialización del monitor y copia de la configuración actual del sensor
+ *
+ * @param monitor : contexto
+ * @param stuck_samples : conversiones idénticas para dar el dato por congelado, al menos 2 (0 lo desactiva)
+ * @param interval_ms : intervalo entre comprobaciones de registros (0 = HEALTH_CHECK_INTERVAL_MS)
+ * @return HealthEnum_t error si no se puede leer la configuración
+ */
+HealthEnum_t Init_Health_Monitor(struct HealthMonitor *monitor, uint8_t stuck_samples, uint32_t interval_ms)
+{
+    memset(monitor, 0, sizeof(*monitor));
+    monitor->stuck_samples = stuck_samples == 1 ? 2 : stuck_samples;
+    monitor->interval_us = (interval_ms > 0 ? interval_ms : HEALTH_CHECK_INTERVAL_MS) * 1000;
+    monitor->last_check_us = micros();
+    return Health_Update_Shadow(monitor);
+}
+
+/**
+ * @brief Nueva copia de la configuración, tras cambiarla a propósito
+ *
+ * @param monitor : contexto
+ * @return HealthEnum_t error/success
+ */
+HealthEnum_t Health_Update_Shadow(struct HealthMonitor *monitor)
+{
+    return Read_Config(monitor->shadow) ? HEALTH_SUCCESS : HEALTH_FAILED;
+}
+
+/**
+ * @brief Registro de una conversión en bruto para detectar datos congelados
+ *
+ * Una lectura sin conversión nueva (sin drdy en REG_STATUS) repite la anterior y no cuenta.
+ *
+ * @param monitor : contexto
+ * @param uncomp_press : presión sin compensar
+ * @param uncomp_temp : temperatura sin compensar
+ * @param status : REG_STATUS leído en la misma ráfaga (HEALTH_NEW_CONVERSION si los datos vienen de la FIFO)
+ */
+void Health_Sample(struct HealthMonitor *monitor, uint32_t uncomp_press, uint32_t uncomp_temp, uint8_t status)
+{
+    if (monitor->stuck_samples == 0 || !(status & HEALTH_NEW_CONVERSION))
+    {
+        return;
+    }
+
+    if (monitor->has_sample && uncomp_press == monitor->last_press && uncomp_temp == monitor->last_temp)
+    {
+        if (monitor->repeats < UINT8_MAX)
+        {
+            monitor->repeats++;
+        }
+        // Con el fallo ya abierto, una nueva racha indica que la recuperación no ha bastado
+        if (monitor->repeats + 1 == monitor->stuck_samples)
+        {
+            if (!(monitor->faults & HEALTH_FAULT_STUCK))
+            {
+                monitor->stats.stuck++;
+                Open_Faults(monitor, HEALTH_FAULT_STUCK);
+            }
+            monitor->check_now = true;
+        }
+    }
+    else
+    {
+        monitor->repeats = 0;
+        if (monitor->faults & HEALTH_FAULT_STUCK)
+        {
+            monitor->faults &= ~HEALTH_FAULT_STUCK;
+            monitor->check_now = false;
+            if (monitor->faults == HEALTH_FAULT_NONE)
+            {
+                Close_Faults(monitor);
+            }
+        }
+    }
+    monitor->last_press = uncomp_press;
+    monitor->last_temp = uncomp_temp;
+    monitor->has_sample = true;
+}
+
+/**
+ * @brief Comprobación de registros cuando vence el intervalo, o en el acto si hay un
+ * dato congelado, y recuperación de los fallos encontrados
+ *
+ * @param monitor : contexto
+ * @return uint8_t fallos abiertos (HealthFault_t)
+ */
+uint8_t Health_Poll(struct HealthMonitor *monitor)
+{
+    uint32_t now = micros();
+    bool stuck = monitor->check_now;
+    uint8_t found;
+    uint8_t err;
+
+    if (!stuck && now - monitor->last_check_us < monitor->interval_us)
+    {
+        return monitor->faults;
+    }
+    monitor->check_now = false;
+    monitor->last_check_us = now;
+    monitor->stats.checks++;
+
+    if (Read_Diagnostics(monitor, &found, &err))
+    {
+        monitor->read_failures = 0;
+        monitor->stats.cmd_errors += (err >> ERR_CMD) & 1;
+        monitor->stats.conf_errors += (err >> ERR_CONF) & 1;
+        monitor->stats.fatal_errors += (found & HEALTH_FAULT_FATAL) ? 1 : 0;
+        monitor->stats.por += (found & HEALTH_FAULT_POR) ? 1 : 0;
+        monitor->stats.mode_drifts += (found & HEALTH_FAULT_MODE) ? 1 : 0;
+        monitor->stats.config_drifts += (found & HEALTH_FAULT_CONFIG) ? 1 : 0;
+    }
+    else
+    {
+        monitor->stats.read_failures++;
+        if (++monitor->read_failures < HEALTH_MAX_READ_FAILURES)
+        {
+            return monitor->faults;
+        }
+        monitor->read_failures = 0;
+        found = HEALTH_FAULT_BUS;
+    }
+
+    Open_Faults(monitor, found);
+    if (found != HEALTH_FAULT_NONE || stuck)
+    {
+        Recover(monitor);
+    }
+    return monitor->faults;
+}
+
+/**
+ * @brief Copia de los contadores
+ *
+ * @param monitor : contexto
+ * @param stats : parámetro de salida
+ */
+void Get_Health_Stats(const struct HealthMonitor *monitor, struct HealthStats *stats)
+{
+    *stats = monitor->stats;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Arduino.h"
+#include "def.h"
+
+/*
+ * Monitor de salud del sensor, pensado para el bucle de adquisición. Detecta datos
+ * congelados (misma lectura en bruto durante varias conversiones), errores y arranques
+ * (ERR_REG y EVENT) y cambios de modo o de configuración respecto a una copia de los
+ * registros de configuración. Ante un fallo aplica primero la recuperación mínima
+ * (reescribir PWR_CTRL o restaurar la configuración) y sólo si no basta reinicia el sensor.
+ *
+ * Sólo cuentan las conversiones nuevas (drdy en REG_STATUS): leer más deprisa que el
+ * ODR no da datos congelados.
+ */
+
+// Valor habitual de conversiones idénticas que se consideran dato congelado
+#ifndef HEALTH_STUCK_SAMPLES
+#define HEALTH_STUCK_SAMPLES        16
+#endif
+
+// Bits de REG_STATUS que marcan una conversión aún no leída
+#define HEALTH_NEW_CONVERSION       ((1 << STATUS_DRDY_PRESS) | (1 << STATUS_DRDY_TEMP))
+
+// Intervalo entre comprobaciones de registros
+#define HEALTH_CHECK_INTERVAL_MS    1000
+
+// Lecturas de diagnóstico fallidas seguidas antes del reinicio completo
+#define HEALTH_MAX_READ_FAILURES    3
+
+// Copia de la configuración: de REG_FIFO_WTM a REG_CONFIG en una sola ráfaga
+#define HEALTH_SHADOW_FIRST         REG_FIFO_WTM
+#define HEALTH_SHADOW_LEN           (REG_CONFIG - REG_FIFO_WTM + 1)
+
+typedef enum
+{
+    HEALTH_FAILED = 0,
+    HEALTH_SUCCESS
+} HealthEnum_t;
+
+/*! Fallos detectados (máscara) */
+typedef enum
+{
+    HEALTH_FAULT_NONE = 0x00,
+    HEALTH_FAULT_STUCK = 0x01,  // Dato congelado
+    HEALTH_FAULT_POR = 0x02,    // Arranque del sensor: configuración perdida
+    HEALTH_FAULT_MODE = 0x04,   // PWR_CTRL distinto de la copia, p. ej. en sleep tras una caída de tensión
+    HEALTH_FAULT_CONFIG = 0x08, // Resto de la configuración distinta de la copia
+    HEALTH_FAULT_FATAL = 0x10,  // fatal_err en ERR_REG
+    HEALTH_FAULT_BUS = 0x20     // Diagnóstico ilegible
+} HealthFault_t;
+
+/*! Contadores */
+struct HealthStats
+{
+    uint32_t checks;           // Comprobaciones de registros
+    uint32_t stuck;            // Datos congelados
+    uint32_t por;              // Arranques detectados
+    uint32_t mode_drifts;
+    uint32_t config_drifts;
+    uint32_t fatal_errors;
+    uint32_t cmd_errors;       // Sólo se cuentan
+    uint32_t conf_errors;      // Sólo se cuentan: restaurar la misma configuración no los corrige
+    uint32_t read_failures;
+    uint32_t targeted_reinits; // Recuperaciones sin reinicio del sensor
+    uint32_t full_reinits;
+    uint32_t recoveries;       // Fallos cerrados tras verificar la recuperación
+    uint32_t last_recover_us;  // Tiempo desde la detección hasta la verificación
+    uint32_t max_recover_us;
+    uint32_t total_recover_us;
+};
+
+/*! Contexto del monitor, uno por sensor */
+struct HealthMonitor
+{
+    uint8_t shadow[HEALTH_SHADOW_LEN]; // Configuración esperada
+    uint8_t stuck_samples;
+    uint32_t interval_us;
+    uint32_t last_check_us;
+    uint32_t last_press;               // Última lectura en bruto
+    uint32_t last_temp;
+    uint8_t repeats;                   // Conversiones idénticas seguidas
+    bool has_sample;
+    bool check_now;                    // Dato congelado pendiente de comprobar
+    uint8_t faults;                    // Fallos abiertos (HealthFault_t)
+    uint8_t attempts;                  // Recuperaciones intentadas sobre el fallo abierto
+    uint8_t read_failures;             // Lecturas de diagnóstico fallidas seguidas
+    uint32_t fault_us;                 // Instante de la detección
+    struct HealthStats stats;
+};
+
+/**
+ * @brief Inicialización del monitor y copia de la configuración actual del sensor
+ *
+ * @param monitor : contexto
+ * @param stuck_samples : conversiones idénticas para dar el dato por congelado, al menos 2 (0 lo desactiva)
+ * @param interval_ms : intervalo entre comprobaciones de registros (0 = HEALTH_CHECK_INTERVAL_MS)
+ * @return HealthEnum_t error si no se puede leer la configuración
+ */
+HealthEnum_t Init_Health_Monitor(struct HealthMonitor *monitor, uint8_t stuck_samples, uint32_t interval_ms);
+
+/**
+ * @brief Nueva copia de la configuración, tras cambiarla a propósito
+ *
+ * @param monitor : contexto
+ * @return HealthEnum_t error/success
+ */
+HealthEnum_t Health_Update_Shadow(struct HealthMonitor *monitor);
+
+/**
+ * @brief Registro de una conversión en bruto para detectar datos congelados
+ *
+ * Una lectura sin conversión nueva (sin drdy en REG_STATUS) repite la anterior y no cuenta.
+ *
+ * @param monitor : contexto
+ * @param uncomp_press : presión sin compensar
+ * @param uncomp_temp : temperatura sin compensar
+ * @param status : REG_STATUS leído en la misma ráfaga (HEALTH_NEW_CONVERSION si los datos vienen de la FIFO)
+ */
+void Health_Sample(struct HealthMonitor *monitor, uint32_t uncomp_press, uint32_t uncomp_temp, uint8_t status);
+
+/**
+ * @brief Comprobación de registros cuando vence el intervalo, o en el acto si hay un
+ * dato congelado, y recuperación de los fallos encontrados
+ *
+ * @param monitor : contexto
+ * @return uint8_t fallos abiertos (HealthFault_t)
+ */
+uint8_t Health_Poll(struct HealthMonitor *monitor);
+
+/**
+ * @brief Copia de los contadores
+ *
+ * @param monitor : contexto
+ * @param stats : parámetro de salida
+ */
+void Get_Health_Stats(const struct HealthMonitor *monitor, struct HealthStats *stats);
@@ -2,164 +2,560 @@
 
 TwoWire my_wire = TwoWire(0);
 
-/*!
- * @brief Inicialización del i2c
+static struct I2CRetryPolicy policy = {
+    I2C_DEFAULT_RETRIES,
+    I2C_DEFAULT_BACKOFF_US,
+    I2C_DEFAULT_DEADLINE_US,
+    I2C_DEFAULT_REINIT_AFTER};
+static struct I2CStats i2c_stats;
+static uint32_t consecutive_failures = 0;
+static portMUX_TYPE i2c_mux = portMUX_INITIALIZER_UNLOCKED; // Política, estadísticas y fallos seguidos
+static uint32_t wire_timeout_ms = 0;                       // Último timeout aplicado a Wire
+
+static struct I2CConfig i2c_config = {
+    SDA_I2C,
+    SCL_I2C,
+    I2C_CLOCK_400K,
+    false};
+static uint32_t i2c_clock = I2C_CLOCK_400K;
+static struct I2CSelfTest self_test_result;
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Clasificación del código devuelto por endTransmission()
+ *
+ * @param code : 0 ok, 1 datos demasiado largos, 2 NACK dirección, 3 NACK dato, 4 otro error, 5 timeout
+ * @return I2CEnum_t Error
  */
-I2CEnum_t Init_I2C()
+static I2CEnum_t Classify_Error(uint8_t code)
 {
+    I2CEnum_t rtrn;
+    switch (code)
+    {
+    case 0:
+        rtrn = I2C_SUCCESS;
+        break;
+    case 2:
+        rtrn = I2C_NACK_ADDR;
+        break;
+    case 3:
+        rtrn = I2C_NACK_DATA;
+        break;
+    case 4:
+        rtrn = I2C_ARBITRATION_LOST; // Pérdida de arbitraje u otro error del bus
+        break;
+    case 5:
+        rtrn = I2C_TIMEOUT;
+        break;
+    default:
+        rtrn = I2C_FAILED;
+        break;
+    }
+    return rtrn;
+}
 
-    I2CEnum_t reslt;
-    if (my_wire.begin())
+/**
+ * @brief Un único intento de lectura de len bytes desde reg_addr
+ */
+static I2CEnum_t Read_Once(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len)
+{
+    my_wire.beginTransmission(i2c_addr);
+    my_wire.write(reg_addr);
+    I2CEnum_t rtrn = Classify_Error(my_wire.endTransmission());
+    if (rtrn != I2C_SUCCESS)
     {
-        reslt = I2C_SUCCESS;
+        return rtrn;
     }
-    else
+
+    uint8_t bytes_to_read = my_wire.requestFrom(i2c_addr, len);
+    if (bytes_to_read != len || my_wire.available() != len)
     {
-        reslt = I2C_FAILED;
+        // Lectura corta: se vacía el buffer para no contaminar la siguiente transacción
+        while (my_wire.available())
+        {
+            my_wire.read();
+        }
+        return bytes_to_read == 0 ? I2C_NACK_ADDR : I2C_READING_BYTES_FAILED;
     }
-    return reslt;
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        data[i] = my_wire.read();
+    }
+    return I2C_READING_BYTES_SUCCESS;
 }
 
 /**
- * @brief Lectura de registros de 8 bits
- *
- * @param reg_addr : dirección de registros
- * @param i2c_addr : dirección i2c
- * @param data : lectura
- * @return I2CEnum_t Error
+ * @brief Un único intento de escritura de un byte en reg_addr
  */
-I2CEnum_t Read8_bit(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data)
+static I2CEnum_t Write_Once(uint8_t reg_addr, uint8_t i2c_addr, uint8_t data)
 {
-    I2CEnum_t rtrn = I2C_READING_BYTES_FAILED;
-    uint8_t byte_size = 1;
-
     my_wire.beginTransmission(i2c_addr);
     my_wire.write(reg_addr);
-    my_wire.endTransmission();
-    my_wire.requestFrom(i2c_addr, byte_size);
-    uint8_t bytes_to_read = my_wire.available();
+    my_wire.write(data);
+    return Classify_Error(my_wire.endTransmission());
+}
+
+/**
+ * @brief Registro del resultado de una transacción en las estadísticas
+ */
+static void Record_Result(I2CEnum_t rslt, uint32_t start)
+{
+    uint32_t latency = micros() - start;
 
-    if (bytes_to_read == byte_size)
+    portENTER_CRITICAL(&i2c_mux);
+    i2c_stats.transactions++;
+    if (latency > i2c_stats.max_latency_us)
     {
+        i2c_stats.max_latency_us = latency;
+    }
 
-        if (my_wire.available())
-        {
-            *data = my_wire.read();
-            rtrn = I2C_READING_BYTES_SUCCESS;
-        }
+    if (rslt == I2C_SUCCESS || rslt == I2C_READING_BYTES_SUCCESS)
+    {
+        consecutive_failures = 0;
     }
-    return rtrn;
+    else
+    {
+        i2c_stats.failures++;
+        consecutive_failures++;
+    }
+    portEXIT_CRITICAL(&i2c_mux);
 }
 
 /**
- * @brief Lectura de registros de 16 bits
+ * @brief Contabilización de un error según su clase
+ */
+static void Count_Error(I2CEnum_t rslt)
+{
+    portENTER_CRITICAL(&i2c_mux);
+    switch (rslt)
+    {
+    case I2C_NACK_ADDR:
+        i2c_stats.nack_addr++;
+        break;
+    case I2C_NACK_DATA:
+        i2c_stats.nack_data++;
+        break;
+    case I2C_TIMEOUT:
+        i2c_stats.timeouts++;
+        break;
+    case I2C_ARBITRATION_LOST:
+        i2c_stats.arbitration++;
+        break;
+    default:
+        i2c_stats.other++;
+        break;
+    }
+    portEXIT_CRITICAL(&i2c_mux);
+}
+
+/**
+ * @brief Actualización del coste de la recuperación con una duración medida; se
+ * conserva el peor para no quedarse corto al reservarlo del plazo
+ */
+static void Record_Recovery(uint32_t elapsed_us)
+{
+    portENTER_CRITICAL(&i2c_mux);
+    if (elapsed_us > i2c_stats.recovery_us)
+    {
+        i2c_stats.recovery_us = elapsed_us;
+    }
+    portEXIT_CRITICAL(&i2c_mux);
+}
+
+/**
+ * @brief Parte del plazo de la transacción que queda por consumir
+ */
+static uint32_t Remaining_Us(uint32_t start, uint32_t deadline_us)
+{
+    uint32_t elapsed = micros() - start;
+    return elapsed < deadline_us ? deadline_us - elapsed : 0;
+}
+
+/**
+ * @brief Duración de la transferencia al reloj del bus: dirección, registro y dirección
+ * de lectura más los datos (o el dato en escritura), a 9 bits por byte
+ *
+ * @param len : bytes a leer (0 para escritura)
+ */
+static uint32_t Transfer_Us(uint8_t len)
+{
+    return (uint32_t)(((uint64_t)len + 3) * 9 * 1000000 / i2c_clock);
+}
+
+/**
+ * @brief Timeout de Wire, que va en ms y se aplica a cada intento por separado
+ *
+ * @param budget_us : plazo disponible para el intento
+ */
+static void Set_Wire_Timeout(uint32_t budget_us)
+{
+    uint32_t ms = budget_us / 1000;
+
+    ms = ms > 0 ? (ms > UINT16_MAX ? UINT16_MAX : ms) : 1;
+    if (ms != wire_timeout_ms)
+    {
+        my_wire.setTimeOut(ms);
+        wire_timeout_ms = ms;
+    }
+}
+
+/**
+ * @brief Transacción con reintentos dentro del plazo de la política
+ *
+ * Cada paso (espera por el bus, intento, recuperación y espera entre intentos) usa sólo
+ * lo que queda del plazo, así que la transacción completa no lo supera. El plazo de la
+ * política se alarga con la duración de la transferencia, para que una ráfaga larga a
+ * reloj bajo quepa en un intento, y la recuperación reserva su coste medido. El bus se
+ * suelta entre intentos para no retener a las otras tareas durante la espera. Las
+ * estadísticas se actualizan bajo i2c_mux porque las comparten tareas de los dos núcleos.
  *
  * @param reg_addr : dirección de registro
  * @param i2c_addr : dirección de i2c
- * @param data : lectura
+ * @param data : buffer de lectura o byte a escribir
+ * @param len : bytes a leer (0 para escritura)
+ * @param prio : prioridad en el bus
  * @return I2CEnum_t Error
  */
-I2CEnum_t Read16_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint16_t *data)
+static I2CEnum_t Transfer(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len, BusPriority_t prio)
 {
-    I2CEnum_t rtrn = I2C_READING_BYTES_FAILED;
-
-    uint8_t byte_size = 2;
-    my_wire.beginTransmission(i2c_addr);
-    my_wire.write(reg_addr);
-    my_wire.endTransmission();
-    my_wire.requestFrom(i2c_addr, byte_size);
-    uint8_t bytes_to_read = my_wire.available();
-
-    if (bytes_to_read == byte_size)
+    struct I2CRetryPolicy current;
+    uint32_t start = micros();
+    uint8_t attempt = 0;
+    I2CEnum_t rtrn = I2C_TIMEOUT;
+
+    portENTER_CRITICAL(&i2c_mux);
+    current = policy;
+    uint32_t recovery_us = i2c_stats.recovery_us;
+    portEXIT_CRITICAL(&i2c_mux);
+    uint32_t transfer_us = Transfer_Us(len);
+    uint32_t attempt_us = transfer_us + I2C_MIN_ATTEMPT_US;
+    uint32_t deadline_us = current.deadline_us + transfer_us;
+
+    while (true)
     {
+        if (Bus_Lock_Us(prio, Remaining_Us(start, deadline_us)) != BUS_LOCK_SUCCESS)
+        {
+            rtrn = I2C_BUS_BUSY;
+            Count_Error(rtrn);
+            break;
+        }
 
-        if (my_wire.available())
+        uint32_t remaining = Remaining_Us(start, deadline_us);
+        if (remaining < attempt_us)
         {
-            uint8_t first = my_wire.read();
+            // La espera por el bus ha agotado el plazo
+            Bus_Unlock();
+            if (attempt == 0)
+            {
+                rtrn = I2C_TIMEOUT;
+                Count_Error(rtrn);
+            }
+            break;
+        }
+        Set_Wire_Timeout(remaining);
 
-            uint8_t second = my_wire.read();
+        rtrn = (len > 0) ? Read_Once(reg_addr, i2c_addr, data, len) : Write_Once(reg_addr, i2c_addr, *data);
+        if (rtrn == I2C_SUCCESS || rtrn == I2C_READING_BYTES_SUCCESS)
+        {
+            Bus_Unlock();
+            break;
+        }
+        Count_Error(rtrn);
 
-            *data = (second << 8) | first;
-            rtrn = I2C_READING_BYTES_SUCCESS;
+        bool retry = attempt < current.max_retries &&
+                     Remaining_Us(start, deadline_us) >= current.backoff_us + attempt_us;
+        // Timeout o pérdida de arbitraje suelen indicar SDA bloqueada por un esclavo
+        if (retry && (rtrn == I2C_TIMEOUT || rtrn == I2C_ARBITRATION_LOST))
+        {
+            retry = Remaining_Us(start, deadline_us) >= recovery_us + current.backoff_us + attempt_us &&
+                    I2C_Recover_Bus() == I2C_SUCCESS;
         }
+        if (retry)
+        {
+            portENTER_CRITICAL(&i2c_mux);
+            i2c_stats.retries++;
+            portEXIT_CRITICAL(&i2c_mux);
+        }
+        Bus_Unlock();
+        if (!retry)
+        {
+            break;
+        }
+        attempt++;
+        delayMicroseconds(current.backoff_us);
     }
 
+    Record_Result(rtrn, start);
     return rtrn;
 }
 
 /**
- * @brief Lectura de registros de 24 bits
+ * @brief Arranque de TwoWire con los pines y el reloj actuales
+ */
+static bool Begin_Wire()
+{
+    bool rtrn = my_wire.begin(i2c_config.sda, i2c_config.scl, i2c_clock);
+    if (rtrn)
+    {
+        struct I2CRetryPolicy current;
+
+        // begin() puede dejar su propio timeout: se fuerza a reescribirlo
+        Get_I2C_Retry_Policy(&current);
+        wire_timeout_ms = 0;
+        Set_Wire_Timeout(current.deadline_us);
+    }
+    return rtrn;
+}
+
+/**
+ * @brief Ronda de lecturas del bloque de calibración a un reloj dado
  *
- * @param reg_addr : dirección de registro
- * @param i2c_addr : dirección de i2c
- * @param data : lectura de registro
- * @return I2CEnum_t Error
+ * @param clock_hz : reloj del bus
+ * @param result : rendimiento y errores medidos
  */
-I2CEnum_t Read24_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data)
+static void Self_Test_Round(uint32_t clock_hz, struct I2CSelfTest *result)
 {
-    I2CEnum_t rtrn = I2C_READING_BYTES_FAILED;
-    uint8_t byte_size = 3;
+    uint8_t reference[I2C_SELF_TEST_BLOCK];
+    uint8_t block[I2C_SELF_TEST_BLOCK];
+    bool has_reference = false;
+    uint32_t bytes = 0;
+
+    my_wire.setClock(clock_hz);
+    i2c_clock = clock_hz;
+    result->clock_hz = clock_hz;
+    result->transfers = 0;
+    result->errors = 0;
+
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < I2C_SELF_TEST_ROUNDS; i++)
+    {
+        result->transfers++;
+        if (Read_Once(NVM_PAR_T1, ADDR_I2C, block, I2C_SELF_TEST_BLOCK) != I2C_READING_BYTES_SUCCESS)
+        {
+            result->errors++;
+            continue;
+        }
+        bytes += I2C_SELF_TEST_BLOCK;
 
-    my_wire.beginTransmission(i2c_addr);
-    my_wire.write(reg_addr);
-    my_wire.endTransmission();
-    my_wire.requestFrom(i2c_addr, byte_size);
-    uint8_t bytes_to_read = my_wire.available();
+        // La calibración es constante: cualquier diferencia es un error de transmisión
+        if (!has_reference)
+        {
+            memcpy(reference, block, I2C_SELF_TEST_BLOCK);
+            has_reference = true;
+        }
+        else if (memcmp(reference, block, I2C_SELF_TEST_BLOCK) != 0)
+        {
+            result->errors++;
+        }
+    }
+    uint32_t elapsed = micros() - start;
+
+    result->bytes_per_s = elapsed > 0 ? (uint32_t)((uint64_t)bytes * 1000000 / elapsed) : 0;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/*!
+ * @brief Inicialización del i2c con la configuración actual
+ */
+I2CEnum_t Init_I2C()
+{
 
-    if (bytes_to_read == byte_size)
+    I2CEnum_t reslt = I2C_FAILED;
+    i2c_clock = i2c_config.clock_hz;
+    if (Init_Bus() == BUS_LOCK_SUCCESS)
     {
-        if (my_wire.available())
+        uint32_t begin_start = micros();
+        if (Begin_Wire())
         {
-            uint32_t first = my_wire.read();
+            // Hasta medir una recuperación: pulsos, STOP y el arranque de Wire que la cierra
+            Record_Recovery(I2C_RECOVERY_US + (micros() - begin_start));
+            reslt = I2C_SUCCESS;
+            if (i2c_config.self_test)
+            {
+                reslt = I2C_Self_Test(&self_test_result);
+            }
+        }
+    }
+    return reslt;
+}
+
+/**
+ * @brief Seteo de pines, reloj y autotest. Se aplica en el siguiente Init_I2C().
+ *
+ * @param config : configuración del bus
+ */
+void Set_I2C_Config(const struct I2CConfig *config)
+{
+    i2c_config = *config;
+}
 
-            uint32_t second = my_wire.read();
+/**
+ * @brief Autotest del bus: mide rendimiento y tasa de errores leyendo en ráfaga el
+ * bloque de calibración, y baja el reloj (1 MHz -> 400 kHz -> 100 kHz) mientras la
+ * tasa de errores supere I2C_SELF_TEST_MAX_ERRORS.
+ *
+ * @param result : resultado al reloj finalmente elegido
+ * @return I2CEnum_t I2C_SUCCESS si algún reloj es fiable
+ */
+I2CEnum_t I2C_Self_Test(struct I2CSelfTest *result)
+{
+    static const uint32_t clocks[] = {I2C_CLOCK_1M, I2C_CLOCK_400K, I2C_CLOCK_100K};
+    I2CEnum_t rtrn = I2C_FAILED;
 
-            uint32_t third = my_wire.read();
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return I2C_BUS_BUSY;
+    }
 
-            *data = (third << 16) | (second << 8) | first;
+    for (uint8_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++)
+    {
+        if (clocks[i] > i2c_config.clock_hz)
+        {
+            continue;
+        }
 
-            rtrn = I2C_READING_BYTES_SUCCESS;
+        Self_Test_Round(clocks[i], result);
+        if (result->errors <= I2C_SELF_TEST_MAX_ERRORS)
+        {
+            rtrn = I2C_SUCCESS;
+            break;
         }
     }
 
+    Bus_Unlock();
     return rtrn;
 }
 
 /**
- * @brief Lectura de registros 32 bits
+ * @brief Resultado del último autotest hecho en Init_I2C()
  *
- * @param reg_addr : dirección de registro
+ * @param result : parámetro de salida
+ */
+void Get_I2C_Self_Test(struct I2CSelfTest *result)
+{
+    *result = self_test_result;
+}
+
+/**
+ * @brief Reloj del bus en uso, tras el posible ajuste del autotest
+ *
+ * @return uint32_t frecuencia en Hz
+ */
+uint32_t Get_I2C_Clock()
+{
+    return i2c_clock;
+}
+
+/**
+ * @brief Lectura de varios registros consecutivos en una sola transacción
+ *
+ * @param reg_addr : dirección del primer registro
  * @param i2c_addr : dirección de i2c
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_Read_Bytes(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len)
+{
+    if (len == 0)
+    {
+        return I2C_READING_BYTES_FAILED;
+    }
+    return Transfer(reg_addr, i2c_addr, data, len, BUS_PRIO_HIGH);
+}
+
+/**
+ * @brief Lectura en ráfaga de baja prioridad (descargas de FIFO)
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_Read_Bulk(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len)
+{
+    if (len == 0)
+    {
+        return I2C_READING_BYTES_FAILED;
+    }
+    return Transfer(reg_addr, i2c_addr, data, len, BUS_PRIO_LOW);
+}
+
+/**
+ * @brief Lectura de registros de 8 bits
+ *
+ * @param reg_addr : dirección de registros
+ * @param i2c_addr : dirección i2c
  * @param data : lectura
  * @return I2CEnum_t Error
  */
-I2CEnum_t Read32_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data)
+I2CEnum_t Read8_bit(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data)
 {
-    I2CEnum_t rtrn = I2C_READING_BYTES_FAILED;
-    uint8_t byte_size = 4;
+    return I2C_Read_Bytes(reg_addr, i2c_addr, data, 1);
+}
 
-    my_wire.beginTransmission(i2c_addr);
-    my_wire.write(reg_addr);
-    my_wire.endTransmission();
-    my_wire.requestFrom(i2c_addr, byte_size);
-    uint8_t bytes_to_read = my_wire.available();
+/**
+ * @brief Lectura de registros de 16 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : lectura
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t Read16_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint16_t *data)
+{
+    uint8_t bytes[2];
+    I2CEnum_t rtrn = I2C_Read_Bytes(reg_addr, i2c_addr, bytes, 2);
 
-    if (bytes_to_read == byte_size)
+    if (rtrn == I2C_READING_BYTES_SUCCESS)
     {
-        if (my_wire.available())
-        {
-            uint32_t first = my_wire.read();
+        *data = (bytes[1] << 8) | bytes[0];
+    }
 
-            uint32_t second = my_wire.read();
+    return rtrn;
+}
 
-            uint32_t third = my_wire.read();
+/**
+ * @brief Lectura de registros de 24 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : lectura de registro
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t Read24_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data)
+{
+    uint8_t bytes[3];
+    I2CEnum_t rtrn = I2C_Read_Bytes(reg_addr, i2c_addr, bytes, 3);
 
-            uint32_t fourth = my_wire.read();
+    if (rtrn == I2C_READING_BYTES_SUCCESS)
+    {
+        *data = ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[1] << 8) | bytes[0];
+    }
 
-            *data = (fourth << 24) | (third << 16) | (second << 8) | first;
+    return rtrn;
+}
 
-            rtrn = I2C_READING_BYTES_SUCCESS;
-        }
+/**
+ * @brief Lectura de registros 32 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : lectura
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t Read32_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data)
+{
+    uint8_t bytes[4];
+    I2CEnum_t rtrn = I2C_Read_Bytes(reg_addr, i2c_addr, bytes, 4);
+
+    if (rtrn == I2C_READING_BYTES_SUCCESS)
+    {
+        *data = ((uint32_t)bytes[3] << 24) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[1] << 8) | bytes[0];
     }
 
     return rtrn;
@@ -170,15 +566,11 @@ I2CEnum_t Read32_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data)
  * @param[in] addr_i2c : dirección de i2c
  * @param[in] reg_addr : dirección de registro
  * @param[in] data : dato que escribimos en el registro
- * @return Escribimos en el registro el dato que queremos
+ * @return I2CEnum_t Error
  */
-void Write8_bit(uint8_t addr_i2c, uint8_t reg_addr, uint8_t data)
+I2CEnum_t Write8_bit(uint8_t addr_i2c, uint8_t reg_addr, uint8_t data)
 {
-
-    my_wire.beginTransmission(addr_i2c);
-    my_wire.write(reg_addr);
-    my_wire.write(data);
-    my_wire.endTransmission();
+    return Transfer(reg_addr, addr_i2c, &data, 0, BUS_PRIO_HIGH);
 }
 
 /*!
@@ -196,6 +588,10 @@ uint8_t Set_Binary(uint8_t binary_num, uint8_t flag, uint8_t pos)
     {
         rslt = binary_num | (1 << pos);
     }
+    else
+    {
+        rslt = binary_num & ~(1 << pos);
+    }
     return rslt;
 }
 
@@ -205,20 +601,140 @@ uint8_t Set_Binary(uint8_t binary_num, uint8_t flag, uint8_t pos)
  * @param[in] reg_addr : dirección de registro
  * @param[in] pos : posición a cambiar
  * @param[in] value : valor del bit
- * @return La escritura en bandera de un registro
+ * @return I2CEnum_t Error
  */
-void Write8_Flag(uint8_t addr_i2c, uint8_t reg_addr, uint8_t pos, uint8_t value)
+I2CEnum_t Write8_Flag(uint8_t addr_i2c, uint8_t reg_addr, uint8_t pos, uint8_t value)
 {
     uint8_t value_byte;
 
-    uint8_t rslt = Read8_bit(reg_addr, addr_i2c, &value_byte);
-    uint8_t reading = value_byte;
+    // Lectura-modificación-escritura atómica respecto a otras tareas
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return I2C_BUS_BUSY;
+    }
+
+    I2CEnum_t rslt = Read8_bit(reg_addr, addr_i2c, &value_byte);
 
     if (rslt == I2C_READING_BYTES_SUCCESS)
     {
-        reading = Set_Binary(reg_addr, value, pos);
-        Write8_bit(addr_i2c, reg_addr, reading);
+        uint8_t reading = Set_Binary(value_byte, value, pos);
+        rslt = Write8_bit(addr_i2c, reg_addr, reading);
     }
+    Bus_Unlock();
+    return rslt;
 }
 
+/*!
+ * @brief Recuperación del bus: 9 pulsos de SCL para liberar SDA y condición de STOP
+ * @return I2CEnum_t error/success
+ */
+I2CEnum_t I2C_Recover_Bus()
+{
+    I2CEnum_t rtrn = I2C_FAILED;
+
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return I2C_BUS_BUSY;
+    }
+
+    uint32_t start = micros();
+    my_wire.end();
+    pinMode(i2c_config.sda, INPUT_PULLUP);
+    pinMode(i2c_config.scl, OUTPUT_OPEN_DRAIN);
+    digitalWrite(i2c_config.scl, HIGH);
+
+    for (uint8_t i = 0; i < 9 && digitalRead(i2c_config.sda) == LOW; i++)
+    {
+        digitalWrite(i2c_config.scl, LOW);
+        delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+        digitalWrite(i2c_config.scl, HIGH);
+        delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    }
+
+    // STOP: SDA sube con SCL en alto
+    pinMode(i2c_config.sda, OUTPUT_OPEN_DRAIN);
+    digitalWrite(i2c_config.sda, LOW);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    digitalWrite(i2c_config.sda, HIGH);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+
+    if (Begin_Wire())
+    {
+        rtrn = I2C_SUCCESS;
+    }
+    Record_Recovery(micros() - start);
+    portENTER_CRITICAL(&i2c_mux);
+    i2c_stats.recoveries++;
+    portEXIT_CRITICAL(&i2c_mux);
 
+    Bus_Unlock();
+    return rtrn;
+}
+
+/**
+ * @brief Seteo de la política de reintentos
+ *
+ * @param new_policy : reintentos, espera entre intentos y plazo por transacción
+ */
+void Set_I2C_Retry_Policy(const struct I2CRetryPolicy *new_policy)
+{
+    portENTER_CRITICAL(&i2c_mux);
+    policy = *new_policy;
+    portEXIT_CRITICAL(&i2c_mux);
+
+    // El timeout de Wire sólo se toca con el bus tomado; si no se consigue, cada
+    // transacción lo ajusta de todos modos antes de su intento
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) == BUS_LOCK_SUCCESS)
+    {
+        Set_Wire_Timeout(new_policy->deadline_us);
+        Bus_Unlock();
+    }
+}
+
+/**
+ * @brief Política de reintentos en uso, compartida con el backend de ESP-IDF
+ *
+ * @param current : parámetro de salida
+ */
+void Get_I2C_Retry_Policy(struct I2CRetryPolicy *current)
+{
+    portENTER_CRITICAL(&i2c_mux);
+    *current = policy;
+    portEXIT_CRITICAL(&i2c_mux);
+}
+
+/**
+ * @brief Obtención de las estadísticas de errores del i2c
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_I2C_Stats(struct I2CStats *stats)
+{
+    portENTER_CRITICAL(&i2c_mux);
+    *stats = i2c_stats;
+    portEXIT_CRITICAL(&i2c_mux);
+}
+
+/**
+ * @brief Indica si los fallos consecutivos justifican reinicializar el sensor
+ *
+ * @return true si se ha alcanzado policy.reinit_after
+ */
+bool I2C_Needs_Reinit()
+{
+    portENTER_CRITICAL(&i2c_mux);
+    bool rtrn = policy.reinit_after > 0 && consecutive_failures >= policy.reinit_after;
+    portEXIT_CRITICAL(&i2c_mux);
+    return rtrn;
+}
+
+/**
+ * @brief Memoria estática del backend Wire, incluido el objeto TwoWire
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_I2C_Footprint()
+{
+    return sizeof(my_wire) + sizeof(policy) + sizeof(i2c_stats) + sizeof(consecutive_failures) + sizeof(i2c_mux) +
+           sizeof(wire_timeout_ms) + sizeof(i2c_config) + sizeof(i2c_clock) + sizeof(self_test_result);
+}
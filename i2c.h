@@ -1,24 +1,159 @@
 
+#pragma once
+
 #include "Arduino.h"
 #include "Wire.h"
 #include "math.h"
 #include "stdio.h"
+#include "bus.h"
+#include "def.h"
+
+// Política de reintentos por defecto
+#define I2C_DEFAULT_RETRIES         3
+#define I2C_DEFAULT_BACKOFF_US      200
+#define I2C_DEFAULT_DEADLINE_US     5000 // Plazo total por transacción, reintentos incluidos, más lo que
+                                         // dura la propia transferencia al reloj del bus
+#define I2C_DEFAULT_REINIT_AFTER    5    // Transacciones fallidas seguidas antes de reinicializar el sensor
+
+// Relojes del bus
+#define I2C_CLOCK_100K              100000
+#define I2C_CLOCK_400K              400000
+#define I2C_CLOCK_1M                1000000
+
+// Autotest: lecturas del bloque de calibración (NVM_PAR_T1..NVM_PAR_P11) por reloj
+#define I2C_SELF_TEST_BLOCK         21
+#define I2C_SELF_TEST_ROUNDS        50
+#define I2C_SELF_TEST_MAX_ERRORS    0
+
+// Semiperiodo de SCL durante la recuperación del bus (~100 kHz)
+#define I2C_RECOVERY_HALF_PERIOD_US 5
+// Duración de los 9 pulsos y el STOP. El coste real de la recuperación, con el end() y
+// begin() de Wire, se mide (I2CStats::recovery_us) y es el que se reserva del plazo.
+#define I2C_RECOVERY_US             (20 * I2C_RECOVERY_HALF_PERIOD_US)
+
+// El timeout de Wire va en ms: un intento necesita al menos 1 ms de plazo además de la
+// duración de la transferencia
+#define I2C_MIN_ATTEMPT_US          1000
 
 typedef enum
 {
     I2C_FAILED = 0,
     I2C_SUCCESS,
     I2C_READING_BYTES_SUCCESS,
-    I2C_READING_BYTES_FAILED
+    I2C_READING_BYTES_FAILED,
+    I2C_NACK_ADDR,        // El esclavo no responde a su dirección
+    I2C_NACK_DATA,        // El esclavo rechaza un byte de datos
+    I2C_TIMEOUT,          // Transacción fuera de plazo (SCL retenida)
+    I2C_ARBITRATION_LOST, // Pérdida de arbitraje u otro error del bus
+    I2C_BUS_BUSY          // No se ha podido tomar el bus a tiempo
 } I2CEnum_t;
 
+/*! Política de reintentos de una transacción */
+struct I2CRetryPolicy
+{
+    uint8_t max_retries;  // Reintentos tras el primer intento
+    uint32_t backoff_us;  // Espera entre intentos
+    uint32_t deadline_us; // Plazo total de la transacción, sin contar la duración de la transferencia
+    uint8_t reinit_after; // Fallos seguidos antes de reinicializar el sensor (0 desactiva)
+};
+
+/*! Configuración del bus */
+struct I2CConfig
+{
+    int8_t sda;
+    int8_t scl;
+    uint32_t clock_hz; // I2C_CLOCK_100K, I2C_CLOCK_400K o I2C_CLOCK_1M
+    bool self_test;    // Autotest y ajuste del reloj en Init_I2C()
+};
+
+/*! Resultado del autotest */
+struct I2CSelfTest
+{
+    uint32_t clock_hz;    // Reloj elegido
+    uint32_t bytes_per_s; // Rendimiento medido a ese reloj
+    uint16_t transfers;
+    uint16_t errors;
+};
+
+/*! Estadísticas de errores del i2c */
+struct I2CStats
+{
+    uint32_t transactions;
+    uint32_t failures;       // Transacciones fallidas tras agotar reintentos
+    uint32_t retries;
+    uint32_t recoveries;     // Recuperaciones del bus por pulsos de SCL
+    uint32_t nack_addr;
+    uint32_t nack_data;
+    uint32_t timeouts;
+    uint32_t arbitration;
+    uint32_t other;
+    uint32_t max_latency_us; // Peor latencia medida de una transacción
+    uint32_t recovery_us;    // Coste de la recuperación: estimado en Init_I2C(), luego el peor medido
+};
+
+// Bus compartido: otros drivers deben usarlo entre Bus_Lock() y Bus_Unlock()
+extern TwoWire my_wire;
+
 // Funciones i2c
 
 /*!
- * @brief Inicialización del i2c
+ * @brief Inicialización del i2c con la configuración actual
  */
 I2CEnum_t Init_I2C();
 
+/**
+ * @brief Seteo de pines, reloj y autotest. Se aplica en el siguiente Init_I2C().
+ *
+ * @param config : configuración del bus
+ */
+void Set_I2C_Config(const struct I2CConfig *config);
+
+/**
+ * @brief Autotest del bus: mide rendimiento y tasa de errores leyendo en ráfaga el
+ * bloque de calibración, y baja el reloj (1 MHz -> 400 kHz -> 100 kHz) mientras la
+ * tasa de errores supere I2C_SELF_TEST_MAX_ERRORS.
+ *
+ * @param result : resultado al reloj finalmente elegido
+ * @return I2CEnum_t I2C_SUCCESS si algún reloj es fiable
+ */
+I2CEnum_t I2C_Self_Test(struct I2CSelfTest *result);
+
+/**
+ * @brief Resultado del último autotest hecho en Init_I2C()
+ *
+ * @param result : parámetro de salida
+ */
+void Get_I2C_Self_Test(struct I2CSelfTest *result);
+
+/**
+ * @brief Reloj del bus en uso, tras el posible ajuste del autotest
+ *
+ * @return uint32_t frecuencia en Hz
+ */
+uint32_t Get_I2C_Clock();
+
+/**
+ * @brief Lectura de varios registros consecutivos en una sola transacción
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_Read_Bytes(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief Lectura en ráfaga de baja prioridad (descargas de FIFO)
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param i2c_addr : dirección de i2c
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_Read_Bulk(uint8_t reg_addr, uint8_t i2c_addr, uint8_t *data, uint8_t len);
+
 /**
  * @brief Lectura de registros de 8 bits
  *
@@ -63,9 +198,9 @@ uint8_t Set_Binary(uint8_t binary_num, uint8_t flag, uint8_t pos);
  * @param[in] addr_i2c : dirección de i2c
  * @param[in] reg_addr : dirección de registro
  * @param[in] data : dato que escribimos en el registro
- * @return Escribimos en el registro el dato que queremos
+ * @return I2CEnum_t Error
  */
-void Write8_bit(uint8_t addr_i2c, uint8_t reg_addr, uint8_t data);
+I2CEnum_t Write8_bit(uint8_t addr_i2c, uint8_t reg_addr, uint8_t data);
 
 /*!
  * @brief Escritura por bandera en registro
@@ -73,9 +208,9 @@ void Write8_bit(uint8_t addr_i2c, uint8_t reg_addr, uint8_t data);
  * @param[in] reg_addr : dirección de registro
  * @param[in] pos : posición a cambiar
  * @param[in] value : valor del bit
- * @return La escritura en bandera de un registro
+ * @return I2CEnum_t Error
  */
-void Write8_Flag(uint8_t addr_i2c, uint8_t reg_addr, uint8_t pos, uint8_t value);
+I2CEnum_t Write8_Flag(uint8_t addr_i2c, uint8_t reg_addr, uint8_t pos, uint8_t value);
 
 /**
  * @brief Lectura de registros 32 bits
@@ -86,3 +221,44 @@ void Write8_Flag(uint8_t addr_i2c, uint8_t reg_addr, uint8_t pos, uint8_t value)
  * @return I2CEnum_t Error
  */
 I2CEnum_t Read32_Bit(uint8_t reg_addr, uint8_t i2c_addr, uint32_t *data);
+
+/*!
+ * @brief Recuperación del bus: 9 pulsos de SCL para liberar SDA y condición de STOP
+ * @return I2CEnum_t error/success
+ */
+I2CEnum_t I2C_Recover_Bus();
+
+/**
+ * @brief Seteo de la política de reintentos
+ *
+ * @param new_policy : reintentos, espera entre intentos y plazo por transacción
+ */
+void Set_I2C_Retry_Policy(const struct I2CRetryPolicy *new_policy);
+
+/**
+ * @brief Política de reintentos en uso, compartida con el backend de ESP-IDF
+ *
+ * @param current : parámetro de salida
+ */
+void Get_I2C_Retry_Policy(struct I2CRetryPolicy *current);
+
+/**
+ * @brief Obtención de las estadísticas de errores del i2c
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_I2C_Stats(struct I2CStats *stats);
+
+/**
+ * @brief Indica si los fallos consecutivos justifican reinicializar el sensor
+ *
+ * @return true si se ha alcanzado policy.reinit_after
+ */
+bool I2C_Needs_Reinit();
+
+/**
+ * @brief Memoria estática del backend Wire, incluido el objeto TwoWire
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_I2C_Footprint();
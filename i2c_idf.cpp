@@ -0,0 +1,455 @@
+#include "i2c_idf.h"
+
+static struct I2CConfig idf_config = {SDA_I2C, SCL_I2C, I2C_CLOCK_400K, false};
+static struct I2CIdfStats idf_stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, I2C_RECOVERY_US};
+static uint32_t consecutive_failures = 0;
+static portMUX_TYPE idf_mux = portMUX_INITIALIZER_UNLOCKED; // Estadísticas y fallos seguidos
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Configuración del bus, antes de Init_I2C_IDF()
+ *
+ * @param config : pines y reloj
+ */
+void Set_I2C_IDF_Config(const struct I2CConfig *config)
+{
+    idf_config = *config;
+}
+
+/**
+ * @brief Reloj del bus configurado
+ *
+ * @return uint32_t frecuencia en Hz
+ */
+uint32_t Get_I2C_IDF_Clock()
+{
+    return idf_config.clock_hz;
+}
+
+/**
+ * @brief Indica si los fallos consecutivos justifican reinicializar el sensor
+ *
+ * @return true si se ha alcanzado reinit_after de la política de reintentos
+ */
+bool I2C_IDF_Needs_Reinit()
+{
+    struct I2CRetryPolicy policy;
+
+    Get_I2C_Retry_Policy(&policy);
+    portENTER_CRITICAL(&idf_mux);
+    bool rtrn = policy.reinit_after > 0 && consecutive_failures >= policy.reinit_after;
+    portEXIT_CRITICAL(&idf_mux);
+    return rtrn;
+}
+
+/**
+ * @brief Copia de las estadísticas del backend
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_I2C_IDF_Stats(struct I2CIdfStats *stats)
+{
+    portENTER_CRITICAL(&idf_mux);
+    *stats = idf_stats;
+    portEXIT_CRITICAL(&idf_mux);
+}
+
+#ifdef USE_I2C_IDF
+
+#include "driver/i2c_master.h"
+
+static i2c_master_bus_handle_t bus_handle = NULL;
+static i2c_master_dev_handle_t dev_handles[2] = {NULL, NULL}; // ADDR_I2C y ADDR_I2C_ALT
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Traducción del error del driver y registro del intento en las estadísticas
+ */
+static I2CEnum_t Classify_Error(esp_err_t err, uint32_t start, I2CEnum_t ok)
+{
+    uint32_t latency = micros() - start;
+    I2CEnum_t rtrn;
+
+    portENTER_CRITICAL(&idf_mux);
+    idf_stats.transactions++;
+    if (latency > idf_stats.max_latency_us)
+    {
+        idf_stats.max_latency_us = latency;
+    }
+
+    switch (err)
+    {
+    case ESP_OK:
+        rtrn = ok;
+        break;
+    case ESP_ERR_TIMEOUT:
+        idf_stats.timeouts++;
+        rtrn = I2C_TIMEOUT;
+        break;
+    case ESP_ERR_INVALID_STATE:
+    case ESP_ERR_INVALID_RESPONSE:
+        // El driver no distingue NACK de dirección y de datos
+        idf_stats.nacks++;
+        rtrn = I2C_NACK_ADDR;
+        break;
+    default:
+        rtrn = I2C_FAILED;
+        break;
+    }
+    portEXIT_CRITICAL(&idf_mux);
+    return rtrn;
+}
+
+/**
+ * @brief Dispositivo del driver para una de las dos direcciones del BMP388
+ *
+ * @return i2c_master_dev_handle_t NULL si la dirección no es del sensor o no se ha registrado
+ */
+static i2c_master_dev_handle_t Device(uint8_t i2c_addr)
+{
+    if (i2c_addr == ADDR_I2C)
+    {
+        return dev_handles[0];
+    }
+    return i2c_addr == ADDR_I2C_ALT ? dev_handles[1] : NULL;
+}
+
+/**
+ * @brief Parte del plazo de la transacción que queda por consumir
+ */
+static uint32_t Remaining_Us(uint32_t start, uint32_t deadline_us)
+{
+    uint32_t elapsed = micros() - start;
+    return elapsed < deadline_us ? deadline_us - elapsed : 0;
+}
+
+/**
+ * @brief Duración de la transferencia al reloj del bus, como Transfer_Us() en i2c.cpp
+ *
+ * @param len : bytes a leer (0 para escritura)
+ */
+static uint32_t Transfer_Us(uint16_t len)
+{
+    return (uint32_t)(((uint64_t)len + 3) * 9 * 1000000 / idf_config.clock_hz);
+}
+
+/**
+ * @brief Transacción con reintentos dentro del plazo de la política, como Transfer() en i2c.cpp
+ *
+ * El plazo se alarga con la duración de la transferencia y el timeout del driver va en
+ * ms y se ajusta en cada intento a lo que queda, reservando el coste medido de la
+ * recuperación: tras un timeout el bus se recupera siempre, se reintente o no, para que
+ * la siguiente transacción no lo encuentre bloqueado. Las estadísticas y los fallos
+ * seguidos se actualizan bajo idf_mux porque las comparten tareas de los dos núcleos.
+ *
+ * @param dev : dispositivo del sensor
+ * @param reg_addr : dirección de registro
+ * @param data : buffer de lectura o byte a escribir
+ * @param len : bytes a leer (0 para escritura)
+ * @param prio : prioridad en el bus
+ * @return I2CEnum_t Error
+ */
+static I2CEnum_t Transfer(i2c_master_dev_handle_t dev, uint8_t reg_addr, uint8_t *data, uint16_t len,
+                          BusPriority_t prio)
+{
+    struct I2CRetryPolicy policy;
+    uint32_t start = micros();
+    uint8_t attempt = 0;
+    I2CEnum_t rtrn = I2C_TIMEOUT;
+
+    Get_I2C_Retry_Policy(&policy);
+    portENTER_CRITICAL(&idf_mux);
+    uint32_t recovery_us = idf_stats.recovery_us;
+    portEXIT_CRITICAL(&idf_mux);
+    uint32_t transfer_us = Transfer_Us(len);
+    uint32_t attempt_us = transfer_us + I2C_MIN_ATTEMPT_US + recovery_us;
+    uint32_t deadline_us = policy.deadline_us + transfer_us;
+
+    while (true)
+    {
+        if (Bus_Lock_Us(prio, Remaining_Us(start, deadline_us)) != BUS_LOCK_SUCCESS)
+        {
+            rtrn = I2C_BUS_BUSY;
+            portENTER_CRITICAL(&idf_mux);
+            idf_stats.bus_busy++;
+            portEXIT_CRITICAL(&idf_mux);
+            break;
+        }
+
+        uint32_t remaining = Remaining_Us(start, deadline_us);
+        if (remaining < attempt_us)
+        {
+            if (attempt == 0)
+            {
+                // La espera por el bus ha agotado el plazo
+                rtrn = I2C_TIMEOUT;
+                portENTER_CRITICAL(&idf_mux);
+                idf_stats.timeouts++;
+                portEXIT_CRITICAL(&idf_mux);
+            }
+            Bus_Unlock();
+            break;
+        }
+
+        int timeout_ms = (int)((remaining - recovery_us) / 1000);
+        uint32_t attempt_start = micros();
+        if (len > 0)
+        {
+            esp_err_t err = i2c_master_transmit_receive(dev, &reg_addr, 1, data, len, timeout_ms);
+            rtrn = Classify_Error(err, attempt_start, I2C_READING_BYTES_SUCCESS);
+        }
+        else
+        {
+            uint8_t bytes[2] = {reg_addr, *data};
+            rtrn = Classify_Error(i2c_master_transmit(dev, bytes, 2, timeout_ms), attempt_start, I2C_SUCCESS);
+        }
+        if (rtrn == I2C_SUCCESS || rtrn == I2C_READING_BYTES_SUCCESS)
+        {
+            Bus_Unlock();
+            break;
+        }
+
+        // SDA retenida por el esclavo: se libera antes de soltar el bus
+        bool recovered = rtrn != I2C_TIMEOUT || I2C_IDF_Reset_Bus() == I2C_SUCCESS;
+        bool retry = recovered && attempt < policy.max_retries &&
+                     Remaining_Us(start, deadline_us) >= policy.backoff_us + attempt_us;
+        if (retry)
+        {
+            portENTER_CRITICAL(&idf_mux);
+            idf_stats.retries++;
+            portEXIT_CRITICAL(&idf_mux);
+        }
+        Bus_Unlock();
+        if (!retry)
+        {
+            break;
+        }
+        attempt++;
+        delayMicroseconds(policy.backoff_us);
+    }
+
+    portENTER_CRITICAL(&idf_mux);
+    if (rtrn == I2C_SUCCESS || rtrn == I2C_READING_BYTES_SUCCESS)
+    {
+        idf_stats.bytes_read += len;
+        consecutive_failures = 0;
+    }
+    else
+    {
+        idf_stats.failures++;
+        consecutive_failures++;
+    }
+    portEXIT_CRITICAL(&idf_mux);
+    return rtrn;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Gestor del bus, creación del bus y registro del sensor en el driver
+ *
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t Init_I2C_IDF()
+{
+    if (Init_Bus() != BUS_LOCK_SUCCESS)
+    {
+        return I2C_FAILED;
+    }
+
+    if (bus_handle == NULL)
+    {
+        i2c_master_bus_config_t bus_config = {};
+        bus_config.i2c_port = I2C_IDF_PORT;
+        bus_config.sda_io_num = (gpio_num_t)idf_config.sda;
+        bus_config.scl_io_num = (gpio_num_t)idf_config.scl;
+        bus_config.clk_source = I2C_CLK_SRC_DEFAULT;
+        bus_config.glitch_ignore_cnt = 7;
+        bus_config.flags.enable_internal_pullup = true;
+        if (i2c_new_master_bus(&bus_config, &bus_handle) != ESP_OK)
+        {
+            bus_handle = NULL;
+            return I2C_FAILED;
+        }
+    }
+
+    // Las dos direcciones del BMP388: la del driver y la de un segundo sensor (async.h)
+    const uint8_t addrs[2] = {ADDR_I2C, ADDR_I2C_ALT};
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (dev_handles[i] != NULL)
+        {
+            i2c_master_bus_rm_device(dev_handles[i]);
+            dev_handles[i] = NULL;
+        }
+
+        i2c_device_config_t dev_config = {};
+        dev_config.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+        dev_config.device_address = addrs[i];
+        dev_config.scl_speed_hz = idf_config.clock_hz;
+        if (i2c_master_bus_add_device(bus_handle, &dev_config, &dev_handles[i]) != ESP_OK)
+        {
+            dev_handles[i] = NULL;
+            return I2C_FAILED;
+        }
+    }
+
+    portENTER_CRITICAL(&idf_mux);
+    uint32_t recovery_us = idf_stats.recovery_us;
+    memset(&idf_stats, 0, sizeof(idf_stats));
+    idf_stats.recovery_us = recovery_us;
+    consecutive_failures = 0;
+    portEXIT_CRITICAL(&idf_mux);
+    return i2c_master_probe(bus_handle, ADDR_I2C, I2C_IDF_TIMEOUT_MS) == ESP_OK ? I2C_SUCCESS : I2C_NACK_ADDR;
+}
+
+/**
+ * @brief Lectura en ráfaga: dirección de registro y lectura con START repetido en una transacción
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @param prio : prioridad en el bus
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Read(uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio)
+{
+    return I2C_IDF_Read_Addr(ADDR_I2C, reg_addr, data, len, prio);
+}
+
+/**
+ * @brief Lectura en ráfaga de un sensor en otra dirección
+ *
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ * @param reg_addr : dirección de registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @param prio : prioridad en el bus
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Read_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio)
+{
+    i2c_master_dev_handle_t dev = Device(i2c_addr);
+    if (dev == NULL || len == 0)
+    {
+        return I2C_FAILED;
+    }
+    return Transfer(dev, reg_addr, data, len, prio);
+}
+
+/**
+ * @brief Escritura de un registro de 8 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Write(uint8_t reg_addr, uint8_t data)
+{
+    return I2C_IDF_Write_Addr(ADDR_I2C, reg_addr, data);
+}
+
+/**
+ * @brief Escritura de un registro de un sensor en otra dirección
+ *
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Write_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data)
+{
+    i2c_master_dev_handle_t dev = Device(i2c_addr);
+    if (dev == NULL)
+    {
+        return I2C_FAILED;
+    }
+    return Transfer(dev, reg_addr, &data, 0, BUS_PRIO_HIGH);
+}
+
+/**
+ * @brief Recuperación del bus por el driver
+ *
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Reset_Bus()
+{
+    if (bus_handle == NULL)
+    {
+        return I2C_FAILED;
+    }
+    uint32_t start = micros();
+    I2CEnum_t rtrn = i2c_master_bus_reset(bus_handle) == ESP_OK ? I2C_SUCCESS : I2C_FAILED;
+    uint32_t elapsed = micros() - start;
+
+    // Se conserva el peor coste medido para no quedarse corto al reservarlo del plazo
+    portENTER_CRITICAL(&idf_mux);
+    idf_stats.resets++;
+    if (elapsed > idf_stats.recovery_us)
+    {
+        idf_stats.recovery_us = elapsed;
+    }
+    portEXIT_CRITICAL(&idf_mux);
+    return rtrn;
+}
+
+#else
+
+// Sin USE_I2C_IDF el backend no está disponible y Init_Transport() falla
+
+I2CEnum_t Init_I2C_IDF()
+{
+    return I2C_FAILED;
+}
+
+I2CEnum_t I2C_IDF_Read(uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio)
+{
+    (void)reg_addr;
+    (void)data;
+    (void)len;
+    (void)prio;
+    return I2C_FAILED;
+}
+
+I2CEnum_t I2C_IDF_Write(uint8_t reg_addr, uint8_t data)
+{
+    (void)reg_addr;
+    (void)data;
+    return I2C_FAILED;
+}
+
+I2CEnum_t I2C_IDF_Read_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio)
+{
+    (void)i2c_addr;
+    return I2C_IDF_Read(reg_addr, data, len, prio);
+}
+
+I2CEnum_t I2C_IDF_Write_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data)
+{
+    (void)i2c_addr;
+    return I2C_IDF_Write(reg_addr, data);
+}
+
+I2CEnum_t I2C_IDF_Reset_Bus()
+{
+    return I2C_FAILED;
+}
+
+#endif
+
+/**
+ * @brief Memoria estática del backend; la que reserva el driver al crear el bus no se cuenta
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_I2C_IDF_Footprint()
+{
+#ifdef USE_I2C_IDF
+    return sizeof(idf_config) + sizeof(idf_stats) + sizeof(consecutive_failures) + sizeof(idf_mux) +
+           sizeof(bus_handle) + sizeof(dev_handles);
+#else
+    return sizeof(idf_config) + sizeof(idf_stats) + sizeof(consecutive_failures) + sizeof(idf_mux);
+#endif
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Arduino.h"
+#include "bus.h"
+#include "def.h"
+#include "i2c.h"
+
+/*
+ * Backend i2c sobre el driver i2c_master de ESP-IDF (5.2 o posterior), sin TwoWire.
+ *
+ * Cada lectura es una sola transacción de hardware: escritura de la dirección de
+ * registro, START repetido y lectura directa al buffer del llamador, sin copias ni
+ * troceado a 128 bytes; sólo la FIFO se lee en trozos de BUS_HOLD_LIMIT_US. El driver
+ * espera el final de la transacción bloqueando la tarea hasta la interrupción de fin,
+ * sin sondeo.
+ *
+ * Se registran las dos direcciones del BMP388: las funciones _Addr atienden a un
+ * segundo sensor en el mismo bus (Transport_I2C_Read y Async_I2C_Bus) sin pasar por Wire.
+ *
+ * Los errores siguen la política de reintentos del backend Wire (Set_I2C_Retry_Policy):
+ * reintentos con espera dentro del plazo total y recuperación del bus tras un timeout.
+ * Los fallos seguidos cuentan para I2C_IDF_Needs_Reinit() igual que en Wire.
+ *
+ * Se activa compilando con USE_I2C_IDF. El driver nuevo y el antiguo de ESP-IDF no
+ * pueden convivir en el mismo binario, así que con los cores de Arduino cuyo Wire
+ * usa el driver antiguo no debe llamarse a Init_I2C() en el mismo programa.
+ */
+
+#define I2C_IDF_PORT        0
+#define I2C_IDF_TIMEOUT_MS  20
+
+/*! Estadísticas del backend */
+struct I2CIdfStats
+{
+    uint32_t transactions;   // Transacciones de hardware (una por intento de lectura o escritura)
+    uint32_t bytes_read;
+    uint32_t failures;       // Transacciones fallidas tras agotar reintentos
+    uint32_t retries;
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t bus_busy;       // Intentos sin poder tomar el bus a tiempo
+    uint32_t resets;         // Recuperaciones del bus por el driver
+    uint32_t max_latency_us;
+    uint32_t recovery_us;    // Coste de la recuperación: I2C_RECOVERY_US hasta medir la peor
+};
+
+/**
+ * @brief Configuración del bus, antes de Init_I2C_IDF()
+ *
+ * @param config : pines y reloj
+ */
+void Set_I2C_IDF_Config(const struct I2CConfig *config);
+
+/**
+ * @brief Gestor del bus, creación del bus y registro del sensor en el driver
+ *
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t Init_I2C_IDF();
+
+/**
+ * @brief Reloj del bus configurado
+ *
+ * @return uint32_t frecuencia en Hz
+ */
+uint32_t Get_I2C_IDF_Clock();
+
+/**
+ * @brief Lectura en ráfaga: dirección de registro y lectura con START repetido en una transacción
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @param prio : prioridad en el bus
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Read(uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio);
+
+/**
+ * @brief Lectura en ráfaga de un sensor en otra dirección
+ *
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ * @param reg_addr : dirección de registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @param prio : prioridad en el bus
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Read_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio);
+
+/**
+ * @brief Escritura de un registro de 8 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Write(uint8_t reg_addr, uint8_t data);
+
+/**
+ * @brief Escritura de un registro de un sensor en otra dirección
+ *
+ * @param i2c_addr : ADDR_I2C o ADDR_I2C_ALT
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Write_Addr(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data);
+
+/**
+ * @brief Recuperación del bus por el driver
+ *
+ * @return I2CEnum_t Error
+ */
+I2CEnum_t I2C_IDF_Reset_Bus();
+
+/**
+ * @brief Indica si los fallos consecutivos justifican reinicializar el sensor
+ *
+ * @return true si se ha alcanzado reinit_after de la política de reintentos
+ */
+bool I2C_IDF_Needs_Reinit();
+
+/**
+ * @brief Copia de las estadísticas del backend
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_I2C_IDF_Stats(struct I2CIdfStats *stats);
+
+/**
+ * @brief Memoria estática del backend; la que reserva el driver al crear el bus no se cuenta
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_I2C_IDF_Footprint();
@@ -0,0 +1,396 @@
+#include "pipeline.h"
+#include "fifo.h"
+#include "sensor.h"
+#include "transport.h"
+
+/*! Métricas que sólo escribe la etapa de adquisición */
+struct AcqStats
+{
+    uint32_t acquired;
+    uint32_t bus_errors;
+    uint32_t max_acq_us;
+};
+
+/*! Métricas que sólo escribe la etapa de proceso */
+struct ProcStats
+{
+    uint32_t processed;
+    uint32_t max_proc_us;
+    uint32_t max_latency_us;
+    uint64_t total_latency_us;
+};
+
+static struct PipelineConfig pipeline_config;
+// Cada etapa escribe sólo las suyas y siempre con pipeline_mux tomado, así que
+// Get_Pipeline_Stats() copia una foto coherente, suma de 64 bits incluida
+static struct AcqStats acq_stats;
+static struct ProcStats proc_stats;
+static portMUX_TYPE pipeline_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t fifo_period_us = 0; // Separación entre tramas de la FIFO al ODR en uso
+static struct RawRing raw_ring;
+static uint8_t fifo_raw[FIFO_MAX_BYTES];
+static struct FifoSample fifo_samples[PIPELINE_FIFO_SAMPLES];
+
+// Las etapas se crean una sola vez sobre memoria estática y, paradas, quedan
+// aparcadas en lugar de borrarse: así no se reutiliza un TCB pendiente de limpieza
+static StackType_t acq_stack[PIPELINE_STACK_SIZE];
+static StackType_t proc_stack[PIPELINE_STACK_SIZE];
+static StaticTask_t acq_tcb;
+static StaticTask_t proc_tcb;
+static TaskHandle_t acq_task = NULL;
+static TaskHandle_t proc_task = NULL;
+static volatile bool acq_parked = false;
+static volatile bool proc_parked = false;
+static volatile bool running = false;
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Flanco del pin de interrupción: despierta la etapa de adquisición
+ */
+static void IRAM_ATTR Acquisition_ISR()
+{
+    BaseType_t woken = pdFALSE;
+
+    if (acq_task != NULL)
+    {
+        vTaskNotifyGiveFromISR(acq_task, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief Espera de una etapa parada hasta el siguiente arranque
+ *
+ * Start_Pipeline() borra la marca antes de arrancar: si una parada llega antes de que
+ * la etapa despierte, la marca se vuelve a poner al ver running a false y la parada
+ * no da por aparcada una etapa que aún no ha pasado por aquí.
+ */
+static void Wait_Start(volatile bool *parked)
+{
+    while (!running)
+    {
+        *parked = true;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    *parked = false;
+}
+
+/**
+ * @brief Ciclo de adquisición en ráfaga: sólo mueve bytes del bus al anillo
+ *
+ * @param cycle : métricas del ciclo
+ */
+static void Acquire_Burst(struct AcqStats *cycle)
+{
+    uint8_t data[7];
+    struct RawFrame frame;
+
+    // REG_STATUS va justo antes de los datos: la misma ráfaga dice si la conversión es nueva
+    if (Transport_Read(REG_STATUS, data, 7) != TRANSPORT_SUCCESS)
+    {
+        cycle->bus_errors++;
+        return;
+    }
+
+    frame.uncomp_press = ((uint32_t)data[3] << 16) | ((uint32_t)data[2] << 8) | data[1];
+    frame.uncomp_temp = ((uint32_t)data[6] << 16) | ((uint32_t)data[5] << 8) | data[4];
+    frame.acq_us = micros();
+    if (pipeline_config.health != NULL)
+    {
+        Health_Sample(pipeline_config.health, frame.uncomp_press, frame.uncomp_temp, data[0]);
+    }
+    if (Ring_Push(&raw_ring, &frame))
+    {
+        cycle->acquired++;
+    }
+}
+
+/**
+ * @brief Ciclo de adquisición por FIFO: descarga y reparto de tramas al anillo
+ *
+ * La última trama es la conversión más reciente; las anteriores se sellan hacia atrás
+ * a un periodo del ODR cada una.
+ *
+ * @param cycle : métricas del ciclo
+ */
+static void Acquire_FIFO(struct AcqStats *cycle)
+{
+    uint16_t count;
+    struct RawFrame frame;
+
+    if (Drain_FIFO(fifo_raw, fifo_samples, PIPELINE_FIFO_SAMPLES, &count) != FIFO_SUCCESS)
+    {
+        cycle->bus_errors++;
+        return;
+    }
+
+    uint32_t drained_us = micros();
+    for (uint16_t i = 0; i < count; i++)
+    {
+        // Sólo se envían tramas completas: la compensación necesita ambas magnitudes
+        if (fifo_samples[i].flags != (FIFO_SAMPLE_PRESS | FIFO_SAMPLE_TEMP))
+        {
+            continue;
+        }
+        frame.uncomp_press = fifo_samples[i].uncomp_press;
+        frame.uncomp_temp = fifo_samples[i].uncomp_temp;
+        frame.acq_us = drained_us - (uint32_t)(count - 1 - i) * fifo_period_us;
+        if (pipeline_config.health != NULL)
+        {
+            // Cada trama de la FIFO es una conversión distinta
+            Health_Sample(pipeline_config.health, frame.uncomp_press, frame.uncomp_temp, HEALTH_NEW_CONVERSION);
+        }
+        if (Ring_Push(&raw_ring, &frame))
+        {
+            cycle->acquired++;
+        }
+    }
+}
+
+/**
+ * @brief Bucle de adquisición hasta la parada
+ */
+static void Run_Acquisition()
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t period = pdMS_TO_TICKS(pipeline_config.period_ms);
+
+    while (running)
+    {
+        struct AcqStats cycle = {0, 0, 0};
+        uint32_t start = micros();
+        if (pipeline_config.source == PIPELINE_FIFO)
+        {
+            Acquire_FIFO(&cycle);
+        }
+        else
+        {
+            Acquire_Burst(&cycle);
+        }
+        if (pipeline_config.health != NULL)
+        {
+            // Registros cada intervalo, o en el acto ante un dato congelado
+            Health_Poll(pipeline_config.health);
+        }
+
+        uint32_t elapsed = micros() - start;
+        portENTER_CRITICAL(&pipeline_mux);
+        acq_stats.acquired += cycle.acquired;
+        acq_stats.bus_errors += cycle.bus_errors;
+        if (elapsed > acq_stats.max_acq_us)
+        {
+            acq_stats.max_acq_us = elapsed;
+        }
+        portEXIT_CRITICAL(&pipeline_mux);
+
+        if (Ring_Count(&raw_ring) > 0)
+        {
+            xTaskNotifyGive(proc_task);
+        }
+        if (pipeline_config.use_int)
+        {
+            // Dormida hasta el aviso del sensor; el plazo cubre un flanco perdido y la parada
+            ulTaskNotifyTake(pdTRUE, period > 0 ? period : pdMS_TO_TICKS(100));
+        }
+        else
+        {
+            vTaskDelayUntil(&last_wake, period > 0 ? period : 1);
+        }
+    }
+}
+
+/**
+ * @brief Etapa de adquisición
+ */
+static void Acquisition_Task(void *arg)
+{
+    (void)arg;
+    while (true)
+    {
+        Wait_Start(&acq_parked);
+        Run_Acquisition();
+    }
+}
+
+/**
+ * @brief Bucle de proceso hasta la parada: compensación, filtrado y salida
+ */
+static void Run_Processing()
+{
+    struct RawFrame frame;
+    struct PipelineSample sample;
+    bool has_filtered = false;
+    float filtered = 0.0f;
+
+    while (running)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+        while (Ring_Pop(&raw_ring, &frame))
+        {
+            uint32_t start = micros();
+
+            sample.temp = Compensate_Temperature(frame.uncomp_temp);
+            sample.press = Compensate_Pressure(frame.uncomp_press, sample.temp);
+            filtered = has_filtered ? filtered + pipeline_config.filter_alpha * (sample.press - filtered) : sample.press;
+            has_filtered = true;
+            sample.press_filtered = filtered;
+            sample.acq_us = frame.acq_us;
+
+            if (pipeline_config.output != NULL)
+            {
+                pipeline_config.output(&sample, pipeline_config.user);
+            }
+            if (pipeline_config.aggregator != NULL)
+            {
+                Aggregator_Add(pipeline_config.aggregator, sample.press, sample.temp, sample.acq_us);
+            }
+            if (pipeline_config.events != NULL)
+            {
+                Event_Process(pipeline_config.events, sample.press, sample.acq_us);
+            }
+
+            uint32_t end = micros();
+            uint32_t proc = end - start;
+            uint32_t latency = end - frame.acq_us;
+            portENTER_CRITICAL(&pipeline_mux);
+            proc_stats.processed++;
+            proc_stats.total_latency_us += latency;
+            if (proc > proc_stats.max_proc_us)
+            {
+                proc_stats.max_proc_us = proc;
+            }
+            if (latency > proc_stats.max_latency_us)
+            {
+                proc_stats.max_latency_us = latency;
+            }
+            portEXIT_CRITICAL(&pipeline_mux);
+        }
+    }
+}
+
+/**
+ * @brief Etapa de proceso
+ */
+static void Processing_Task(void *arg)
+{
+    (void)arg;
+    while (true)
+    {
+        Wait_Start(&proc_parked);
+        Run_Processing();
+    }
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Arranque de las dos etapas en sus núcleos
+ *
+ * @param config : configuración
+ * @return PipelineEnum_t error/success
+ */
+PipelineEnum_t Start_Pipeline(const struct PipelineConfig *config)
+{
+    if (running)
+    {
+        return PIPELINE_FAILED;
+    }
+
+    // Separación entre tramas de la FIFO para sellar cada una con su conversión
+    uint8_t odr = 0;
+    if (config->source == PIPELINE_FIFO && Get_Output_Data_Rate(&odr) != GET_ODR_SUCCESS)
+    {
+        return PIPELINE_FAILED;
+    }
+    fifo_period_us = (uint32_t)ODR_BASE_PERIOD_US << (odr & ODR_SEL_MASK);
+
+    pipeline_config = *config;
+    portENTER_CRITICAL(&pipeline_mux);
+    memset(&acq_stats, 0, sizeof(acq_stats));
+    memset(&proc_stats, 0, sizeof(proc_stats));
+    portEXIT_CRITICAL(&pipeline_mux);
+    Init_Ring(&raw_ring);
+
+    // Creación en el primer arranque; los núcleos quedan fijados desde entonces
+    if (proc_task == NULL)
+    {
+        proc_task = xTaskCreateStaticPinnedToCore(Processing_Task, "bmp_proc", PIPELINE_STACK_SIZE, NULL,
+                                                  PIPELINE_PROC_PRIORITY, proc_stack, &proc_tcb, config->proc_core);
+    }
+    if (acq_task == NULL)
+    {
+        acq_task = xTaskCreateStaticPinnedToCore(Acquisition_Task, "bmp_acq", PIPELINE_STACK_SIZE, NULL,
+                                                 PIPELINE_ACQ_PRIORITY, acq_stack, &acq_tcb, config->acq_core);
+    }
+    if (proc_task == NULL || acq_task == NULL)
+    {
+        return PIPELINE_FAILED;
+    }
+
+    acq_parked = false;
+    proc_parked = false;
+    running = true;
+    xTaskNotifyGive(proc_task);
+    xTaskNotifyGive(acq_task);
+    if (config->use_int)
+    {
+        pinMode(config->int_pin, INPUT);
+        // El flanco de aviso sigue la polaridad dada a Set_FIFO_Interrupt()
+        int edge = config->int_active_low ? FALLING : RISING;
+        attachInterrupt(digitalPinToInterrupt(config->int_pin), Acquisition_ISR, edge);
+    }
+    return PIPELINE_SUCCESS;
+}
+
+/*!
+ * @brief Parada de las dos etapas
+ */
+void Stop_Pipeline()
+{
+    if (!running)
+    {
+        return;
+    }
+    if (pipeline_config.use_int)
+    {
+        detachInterrupt(digitalPinToInterrupt(pipeline_config.int_pin));
+    }
+    running = false;
+    while (!acq_parked || !proc_parked)
+    {
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * @brief Obtención de las métricas por etapa
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_Pipeline_Stats(struct PipelineStats *stats)
+{
+    portENTER_CRITICAL(&pipeline_mux);
+    stats->acquired = acq_stats.acquired;
+    stats->bus_errors = acq_stats.bus_errors;
+    stats->max_acq_us = acq_stats.max_acq_us;
+    stats->processed = proc_stats.processed;
+    stats->max_proc_us = proc_stats.max_proc_us;
+    stats->max_latency_us = proc_stats.max_latency_us;
+    stats->total_latency_us = proc_stats.total_latency_us;
+    portEXIT_CRITICAL(&pipeline_mux);
+    stats->dropped = raw_ring.dropped;
+}
+
+/**
+ * @brief Memoria estática del pipeline: pilas, TCB, anillo y búferes de la FIFO
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Pipeline_Footprint()
+{
+    return sizeof(pipeline_config) + sizeof(acq_stats) + sizeof(proc_stats) + sizeof(pipeline_mux) + sizeof(raw_ring) +
+           sizeof(fifo_raw) + sizeof(fifo_samples) + sizeof(acq_stack) + sizeof(proc_stack) + sizeof(acq_tcb) +
+           sizeof(proc_tcb);
+}
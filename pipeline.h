@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Arduino.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "def.h"
+#include "ring.h"
+#include "aggregator.h"
+#include "events.h"
+#include "health.h"
+
+// Núcleos por defecto: adquisición en el PRO_CPU, proceso junto al loop() de Arduino
+#define PIPELINE_ACQ_CORE       0
+#define PIPELINE_PROC_CORE      1
+
+#define PIPELINE_ACQ_PRIORITY   5
+#define PIPELINE_PROC_PRIORITY  4
+
+// Pila de cada etapa en bytes (StackType_t ocupa un byte en ESP-IDF)
+#ifndef PIPELINE_STACK_SIZE
+#define PIPELINE_STACK_SIZE     4096
+#endif
+
+// Muestras por descarga de FIFO
+#ifndef PIPELINE_FIFO_SAMPLES
+#define PIPELINE_FIFO_SAMPLES   74
+#endif
+
+typedef enum
+{
+    PIPELINE_FAILED = 0,
+    PIPELINE_SUCCESS
+} PipelineEnum_t;
+
+/*! Origen de los datos de la etapa de adquisición */
+typedef enum
+{
+    PIPELINE_BURST = 0, // Lectura en ráfaga de presión y temperatura en cada periodo
+    PIPELINE_FIFO       // Descarga de la FIFO en cada periodo
+} PipelineSource_t;
+
+/*! Muestra de salida de la etapa de proceso */
+struct PipelineSample
+{
+    float press;
+    float temp;
+    float press_filtered;
+    uint32_t acq_us; // Instante de la conversión; en FIFO, fechado hacia atrás desde la descarga
+};
+
+typedef void (*PipelineOutput_t)(const struct PipelineSample *sample, void *user);
+
+/*! Configuración del pipeline */
+struct PipelineConfig
+{
+    PipelineSource_t source;
+    uint32_t period_ms;   // Periodo de la etapa de adquisición
+    uint8_t acq_core;
+    uint8_t proc_core;
+    float filter_alpha;   // Filtro exponencial de la presión (1 = sin filtro)
+    PipelineOutput_t output; // Salida por muestra (NULL si sólo se quieren resúmenes)
+    void *user;
+    struct Aggregator *aggregator; // Resúmenes por ventanas de la salida (NULL lo desactiva)
+    struct EventEngine *events;    // Umbrales y velocidad de cambio sobre cada muestra (NULL lo desactiva)
+    bool use_int;                  // Adquisición al flanco del pin de interrupción (FIFO con nivel de aviso)
+    uint8_t int_pin;               // Con use_int, period_ms pasa a ser el plazo máximo de espera
+    bool int_active_low;           // Pin activo a nivel bajo: flanco de bajada (active_high a false en Set_FIFO_Interrupt)
+    struct HealthMonitor *health;  // Comprobación de salud en cada ciclo de adquisición (NULL lo desactiva)
+};
+
+/*! Métricas por etapa */
+struct PipelineStats
+{
+    uint32_t acquired;       // Tramas puestas en el anillo
+    uint32_t processed;      // Muestras entregadas a la salida
+    uint32_t dropped;        // Tramas perdidas por anillo lleno
+    uint32_t bus_errors;     // Lecturas fallidas en la adquisición
+    uint32_t max_acq_us;     // Peor tiempo de un ciclo de adquisición
+    uint32_t max_proc_us;    // Peor tiempo de proceso de una muestra
+    uint32_t max_latency_us; // Peor tiempo desde la conversión hasta la salida
+    uint64_t total_latency_us; // Suma para la media; en 32 bits desborda a los 4295 s acumulados
+};
+
+/**
+ * @brief Arranque de las dos etapas en sus núcleos
+ *
+ * @param config : configuración
+ * @return PipelineEnum_t error/success
+ */
+PipelineEnum_t Start_Pipeline(const struct PipelineConfig *config);
+
+/*!
+ * @brief Parada de las dos etapas
+ */
+void Stop_Pipeline();
+
+/**
+ * @brief Obtención de las métricas por etapa
+ *
+ * @param stats : parámetro de salida
+ */
+void Get_Pipeline_Stats(struct PipelineStats *stats);
+
+/**
+ * @brief Memoria estática del pipeline: pilas, TCB, anillo y búferes de la FIFO
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Pipeline_Footprint();
@@ -0,0 +1,71 @@
+#include "ring.h"
+
+static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE debe ser potencia de 2");
+
+/**
+ * @brief Inicialización del anillo
+ *
+ * @param ring : anillo
+ */
+void Init_Ring(struct RawRing *ring)
+{
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->dropped = 0;
+}
+
+/**
+ * @brief Inserción desde el productor
+ *
+ * @param ring : anillo
+ * @param frame : trama
+ * @return true si había hueco
+ */
+bool Ring_Push(struct RawRing *ring, const struct RawFrame *frame)
+{
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= RING_SIZE)
+    {
+        ring->dropped++;
+        return false;
+    }
+
+    ring->frames[head & (RING_SIZE - 1)] = *frame;
+    ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Extracción desde el consumidor
+ *
+ * @param ring : anillo
+ * @param frame : parámetro de salida
+ * @return true si había alguna trama
+ */
+bool Ring_Pop(struct RawRing *ring, struct RawFrame *frame)
+{
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    *frame = ring->frames[tail & (RING_SIZE - 1)];
+    ring->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Tramas pendientes
+ *
+ * @param ring : anillo
+ * @return uint32_t número de tramas
+ */
+uint32_t Ring_Count(struct RawRing *ring)
+{
+    return ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_acquire);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+#include <atomic>
+
+// Capacidad del anillo, potencia de 2
+#ifndef RING_SIZE
+#define RING_SIZE               64
+#endif
+
+/*! Trama sin compensar que cruza de la etapa de adquisición a la de proceso */
+struct RawFrame
+{
+    uint32_t uncomp_press;
+    uint32_t uncomp_temp;
+    uint32_t acq_us; // Instante de la lectura en el bus
+};
+
+/*!
+ * Anillo sin bloqueos de un productor y un consumidor. Cada índice lo escribe un
+ * único núcleo, así que basta con orden acquire/release entre ambos.
+ */
+struct RawRing
+{
+    struct RawFrame frames[RING_SIZE];
+    std::atomic<uint32_t> head; // Lo escribe sólo el productor
+    std::atomic<uint32_t> tail; // Lo escribe sólo el consumidor
+    uint32_t dropped;           // Tramas perdidas por anillo lleno (productor)
+};
+
+/**
+ * @brief Inicialización del anillo
+ *
+ * @param ring : anillo
+ */
+void Init_Ring(struct RawRing *ring);
+
+/**
+ * @brief Inserción desde el productor
+ *
+ * @param ring : anillo
+ * @param frame : trama
+ * @return true si había hueco
+ */
+bool Ring_Push(struct RawRing *ring, const struct RawFrame *frame);
+
+/**
+ * @brief Extracción desde el consumidor
+ *
+ * @param ring : anillo
+ * @param frame : parámetro de salida
+ * @return true si había alguna trama
+ */
+bool Ring_Pop(struct RawRing *ring, struct RawFrame *frame);
+
+/**
+ * @brief Tramas pendientes
+ *
+ * @param ring : anillo
+ * @return uint32_t número de tramas
+ */
+uint32_t Ring_Count(struct RawRing *ring);
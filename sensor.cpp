@@ -1,15 +1,102 @@
 #include "sensor.h"
 #include "i2c.h"
+#include "i2c_idf.h"
+#include "transport.h"
+#include "compensation.h"
+#include "comp_lut.h"
+#include <atomic>
 
 #define POS_TEMP 0x01
 #define POS_PRESS 0x00
 #define FLAG 0x01
+#define RESET_DELAY_MS 2 // Arranque tras el reinicio por software
+#define PWR_MEASURES (PWR_PRESS_EN | PWR_TEMP_EN | MODE_NORMAL)
 
-static struct DataCoefficients coeff;
-static struct RegCalibData reg_calib_data;
+// Configuración que se restaura tras un reinicio: de REG_FIFO_WTM a REG_CONFIG
+#define CONFIG_FIRST REG_FIFO_WTM
+#define CONFIG_LEN (REG_CONFIG - REG_FIFO_WTM + 1)
+#define REG_RESERVED_1E 0x1E // Hueco entre REG_ODR y REG_CONFIG
+
+/*! Calibración y coeficientes derivados de un mismo juego de lecturas */
+struct CalibSet
+{
+    struct RegCalibData reg;
+    struct DataCoefficients coeff;
+    struct DataCoefficientsDouble coeff_double;
+};
+
+/*! Dos juegos publicados por índice, con los lectores de cada uno contados */
+struct DoubleBuffer
+{
+    std::atomic<uint8_t> active;
+    std::atomic<uint32_t> readers[2];
+};
+
+// Doble búfer: Get_Calib_Coefficients() calcula en el juego retirado, una vez que lo ha
+// soltado el último lector, y lo publica de una vez, así que la tarea de proceso, en el
+// otro núcleo, nunca compensa con un juego a medias mientras Reinit_BMP() recalibra
+static struct CalibSet calib_sets[2];
+static struct DoubleBuffer calib_buffer;
+static std::atomic<float> last_temp(0.0f); // Última temperatura medida, fuera de los juegos publicados
+
+static std::atomic<CompensationMode_t> comp_mode(COMP_FLOAT);
+// Tablas publicadas: Set_Compensation_LUT() calcula en el hueco retirado, una vez sin
+// lectores, y lo publica con un solo cambio de índice
+static const struct CompLut *comp_luts[2] = {NULL, NULL};
+static struct DoubleBuffer lut_buffer;
+static uint8_t config_shadow[CONFIG_LEN];
+static bool config_saved = false;
 
 /*************************************************** FUNCIONES PRIVADAS ***************************************************/
 
+/**
+ * @brief Entrada de un lector en el juego publicado
+ *
+ * Si el juego se retira entre la lectura del índice y el registro del lector, se
+ * reintenta: así el escritor nunca espera a un lector que llega tarde a un juego viejo.
+ *
+ * @return uint8_t índice del juego, a devolver con Buffer_Release()
+ */
+static uint8_t Buffer_Acquire(struct DoubleBuffer *buffer)
+{
+    while (true)
+    {
+        uint8_t slot = buffer->active.load();
+        buffer->readers[slot]++;
+        if (buffer->active.load() == slot)
+        {
+            return slot;
+        }
+        buffer->readers[slot]--;
+    }
+}
+
+/**
+ * @brief Salida de un lector
+ */
+static void Buffer_Release(struct DoubleBuffer *buffer, uint8_t slot)
+{
+    buffer->readers[slot]--;
+}
+
+/**
+ * @brief Juego retirado, una vez que lo han soltado todos sus lectores
+ *
+ * Espera cediendo el núcleo: un lector de menor prioridad puede estar expulsado con
+ * el juego tomado.
+ *
+ * @return uint8_t índice del juego libre para escribir
+ */
+static uint8_t Buffer_Retired(struct DoubleBuffer *buffer)
+{
+    uint8_t slot = buffer->active.load() ^ 1;
+    while (buffer->readers[slot].load() != 0)
+    {
+        delay(1);
+    }
+    return slot;
+}
+
 /*!
  * @brief Lectura de registro de la temperatura
 
@@ -25,14 +112,17 @@ SensorEnum_t Get_Uncompensate_Pressure(uint32_t *uncomp_press);
 /**
  * @brief Lectura de los datos de calibración
  *
+ * @param reg_calib_data : parámetro de salida
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Data();
+SensorEnum_t Get_Calib_Data(struct RegCalibData *reg_calib_data);
 
 /*!
  * @brief Obtención de los coeficientes de calibración
+ *
+ * @return SensorEnum_t error/success de la lectura de la calibración
  */
-void Get_Calib_Coefficients();
+SensorEnum_t Get_Calib_Coefficients();
 
 /**
  * @brief Obtención de temperatura sin compensar
@@ -45,7 +135,7 @@ SensorEnum_t Get_Uncompensate_temperature(uint32_t *uncomp_temp)
     SensorEnum_t error = GET_UNCOMP_MEASURES_FAILED;
     uint32_t data;
 
-    if (Read24_Bit(REG_TEMP, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read24(REG_TEMP, &data) == TRANSPORT_SUCCESS)
     {
         *uncomp_temp = data;
         error = GET_UNCOMP_MEASURES_SUCCESS;
@@ -65,7 +155,7 @@ SensorEnum_t Get_Uncompensate_Pressure(uint32_t *uncomp_press)
     SensorEnum_t error = GET_UNCOMP_MEASURES_FAILED;
     uint32_t data;
 
-    if (Read24_Bit(REG_PRESS, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read24(REG_PRESS, &data) == TRANSPORT_SUCCESS)
     {
         *uncomp_press = data;
         error = GET_UNCOMP_MEASURES_SUCCESS;
@@ -77,111 +167,114 @@ SensorEnum_t Get_Uncompensate_Pressure(uint32_t *uncomp_press)
 /**
  * @brief Obtención de temperatura calibrada
  *
+ * @param temp : parámetro de salida
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Temperature();
+SensorEnum_t Get_Calib_Temperature(float *temp);
 
 /**
  * @brief Obtención de la presión calibrada
  *
  * @param calib_data : parámetro de salida
+ * @param temp : temperatura compensada
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Press(float *calib_data);
+SensorEnum_t Get_Calib_Press(float *calib_data, float temp);
 
 /**
  * @brief Lectura de los datos de calibración
  *
+ * @param reg_calib_data : parámetro de salida
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Data()
+SensorEnum_t Get_Calib_Data(struct RegCalibData *reg_calib_data)
 {
     SensorEnum_t error = GET_CALIB_DATA_FAILED;
     uint8_t value_byte;
     uint16_t value_2bytes;
     uint8_t count = 0;
 
-    if (Read16_Bit(NVM_PAR_T1, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_T1, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_t1 = value_2bytes;
+        reg_calib_data->nvm_par_t1 = value_2bytes;
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_T2, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_T2, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_t2 = value_2bytes;
+        reg_calib_data->nvm_par_t2 = value_2bytes;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_T3, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_T3, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_t3 = int8_t(value_byte);
+        reg_calib_data->nvm_par_t3 = int8_t(value_byte);
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_P1, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_P1, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p1 = (int16_t)value_2bytes;
+        reg_calib_data->nvm_par_p1 = (int16_t)value_2bytes;
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_P2, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_P2, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p2 = (int16_t)value_2bytes;
+        reg_calib_data->nvm_par_p2 = (int16_t)value_2bytes;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P3, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P3, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p3 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p3 = (int8_t)value_byte;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P4, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P4, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p4 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p4 = (int8_t)value_byte;
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_P5, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_P5, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p5 = value_2bytes;
+        reg_calib_data->nvm_par_p5 = value_2bytes;
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_P6, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_P6, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p6 = value_2bytes;
+        reg_calib_data->nvm_par_p6 = value_2bytes;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P7, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P7, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p7 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p7 = (int8_t)value_byte;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P8, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P8, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p8 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p8 = (int8_t)value_byte;
         count++;
     }
 
-    if (Read16_Bit(NVM_PAR_P9, ADDR_I2C, &value_2bytes) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read16(NVM_PAR_P9, &value_2bytes) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p9 = (int16_t)value_2bytes;
+        reg_calib_data->nvm_par_p9 = (int16_t)value_2bytes;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P10, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P10, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p10 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p10 = (int8_t)value_byte;
         count++;
     }
 
-    if (Read8_bit(NVM_PAR_P11, ADDR_I2C, &value_byte) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(NVM_PAR_P11, &value_byte) == TRANSPORT_SUCCESS)
     {
-        reg_calib_data.nvm_par_p11 = (int8_t)value_byte;
+        reg_calib_data->nvm_par_p11 = (int8_t)value_byte;
         count++;
     }
 
@@ -194,52 +287,134 @@ SensorEnum_t Get_Calib_Data()
 
 /*!
  * @brief Obtención de los coeficientes de calibración
+ *
+ * @return SensorEnum_t error/success de la lectura de la calibración
+ */
+SensorEnum_t Get_Calib_Coefficients()
+{
+    uint8_t slot = Buffer_Retired(&calib_buffer);
+    struct CalibSet *next = &calib_sets[slot];
+
+    SensorEnum_t rtrn = Get_Calib_Data(&next->reg);
+    if (rtrn == GET_CALIB_DATA_SUCCESS)
+    {
+        Calc_Coefficients(&next->reg, &next->coeff);
+        Calc_Coefficients_Double(&next->reg, &next->coeff_double);
+        calib_buffer.active.store(slot);
+    }
+    return rtrn;
+}
+
+/**
+ * @brief Compensación de temperatura con un juego de calibración
+ */
+static float Compensate_Temperature_Set(const struct CalibSet *set, uint32_t uncomp_temp)
+{
+    switch (comp_mode.load(std::memory_order_acquire))
+    {
+    case COMP_DOUBLE:
+        return Compensate_Temperature_Double(&set->coeff_double, uncomp_temp);
+    case COMP_FIXED:
+        return Compensate_Temperature_Fixed(&set->reg, uncomp_temp) / 65536.0f;
+    default:
+        return Compensate_Temperature_Float(&set->coeff, uncomp_temp);
+    }
+}
+
+/**
+ * @brief Compensación de presión con un juego de calibración
  */
-void Get_Calib_Coefficients()
+static float Compensate_Pressure_Set(const struct CalibSet *set, uint32_t uncomp_press, float temp)
 {
-    if (Get_Calib_Data() == GET_CALIB_DATA_SUCCESS)
+    switch (comp_mode.load(std::memory_order_acquire))
+    {
+    case COMP_DOUBLE:
+        return Compensate_Pressure_Double(&set->coeff_double, uncomp_press, temp);
+    case COMP_FIXED:
+        // temp * 2^16 cabe sin pérdida en la mantisa del float: es el t_lin original
+        return Compensate_Pressure_Fixed(&set->reg, uncomp_press, (int64_t)(temp * 65536.0f)) / 100.0f;
+    case COMP_LUT:
     {
-        coeff.nvm_t1 = reg_calib_data.nvm_par_t1 / pow(2, -8);
-        coeff.nvm_t2 = reg_calib_data.nvm_par_t2 / pow(2, 30);
-        coeff.nvm_t3 = reg_calib_data.nvm_par_t3 / pow(2, 48);
-        coeff.nvm_p1 = ((reg_calib_data.nvm_par_p1 - pow(2, 14)) / pow(2, 20));
+        uint8_t slot = Buffer_Acquire(&lut_buffer);
+        const struct CompLut *lut = comp_luts[slot];
+        float press = lut != NULL ? Comp_LUT_Pressure(lut, uncomp_press, temp)
+                                  : Compensate_Pressure_Float(&set->coeff, uncomp_press, temp);
+        Buffer_Release(&lut_buffer, slot);
+        return press;
+    }
+    default:
+        return Compensate_Pressure_Float(&set->coeff, uncomp_press, temp);
+    }
+}
 
-        coeff.nvm_p2 = ((reg_calib_data.nvm_par_p2 - pow(2, 14)) / pow(2, 29));
-        coeff.nvm_p3 = reg_calib_data.nvm_par_p3 / pow(2, 32);
+/**
+ * @brief Habilitación de presión y temperatura y paso a modo normal en una sola
+ * escritura, sin pasar por modo forzado
+ *
+ * @return true si la escritura sale bien
+ */
+static bool Enable_Measures()
+{
+    return Transport_Write(REG_PWR_CNTRL, PWR_MEASURES) == TRANSPORT_SUCCESS;
+}
 
-        coeff.nvm_p4 = reg_calib_data.nvm_par_p4 / pow(2, 37);
+/**
+ * @brief Escritura de un registro de configuración y de su copia
+ *
+ * @return true si la escritura sale bien
+ */
+static bool Write_Config(uint8_t reg_addr, uint8_t data)
+{
+    // Con el bus tomado, Reinit_BMP() nunca restaura una copia a medio actualizar
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return false;
+    }
+    bool ok = Transport_Write(reg_addr, data) == TRANSPORT_SUCCESS;
+    if (ok)
+    {
+        config_shadow[reg_addr - CONFIG_FIRST] = data;
+    }
+    Bus_Unlock();
+    return ok;
+}
 
-        coeff.nvm_p5 = reg_calib_data.nvm_par_p5 / pow(2, -3);
-        coeff.nvm_p6 = reg_calib_data.nvm_par_p6 / pow(2, 6);
-        coeff.nvm_p7 = reg_calib_data.nvm_par_p7 / pow(2, 8);
-        coeff.nvm_p8 = reg_calib_data.nvm_par_p8 / pow(2, 15);
-        coeff.nvm_p9 = reg_calib_data.nvm_par_p9 / pow(2, 48);
-        coeff.nvm_p10 = reg_calib_data.nvm_par_p10 / pow(2, 48);
-        coeff.nvm_p11 = reg_calib_data.nvm_par_p11 / pow(2, 65);
+/**
+ * @brief Restauración de la configuración copiada tras un reinicio; OSR, ODR y filtro
+ * sólo se cambian en sleep, así que PWR_CTRL se escribe el último y de una vez
+ *
+ * @return true si todas las escrituras salen bien
+ */
+static bool Restore_Config()
+{
+    bool ok = true;
+    for (uint8_t i = 0; ok && i < CONFIG_LEN; i++)
+    {
+        uint8_t reg = CONFIG_FIRST + i;
+        if (reg != REG_RESERVED_1E && reg != REG_PWR_CNTRL)
+        {
+            ok = Transport_Write(reg, config_shadow[i]) == TRANSPORT_SUCCESS;
+        }
     }
+    return ok && Transport_Write(REG_PWR_CNTRL, config_shadow[REG_PWR_CNTRL - CONFIG_FIRST]) == TRANSPORT_SUCCESS;
 }
 
 /**
  * @brief Obtención de temperatura calibrada
  *
+ * @param temp : parámetro de salida
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Temperature()
+SensorEnum_t Get_Calib_Temperature(float *temp)
 {
     SensorEnum_t error = GET_MEASURES_FAILED;
     uint32_t uncomp_temp;
     if (Get_Uncompensate_temperature(&uncomp_temp) == GET_UNCOMP_MEASURES_SUCCESS)
     {
-        Write8_Flag(ADDR_I2C, REG_PWR_CNTRL, POS_TEMP, FLAG);
-
-        float partial_data1;
-        float partial_data2;
+        Transport_Write_Flag(REG_PWR_CNTRL, POS_TEMP, FLAG);
 
-        partial_data1 = (float)(uncomp_temp - coeff.nvm_t1);
-
-        partial_data2 = (float)(partial_data1 * coeff.nvm_t2);
-
-        coeff.comp_temp = partial_data2 + (partial_data1 * partial_data1) * coeff.nvm_t3;
+        *temp = Compensate_Temperature(uncomp_temp);
+        last_temp.store(*temp);
 
         error = GET_MEASURES_SUCCESS;
     }
@@ -251,63 +426,149 @@ SensorEnum_t Get_Calib_Temperature()
  * @brief Obtención de la presión calibrada
  *
  * @param calib_data : parámetro de salida
+ * @param temp : temperatura compensada
  * @return SensorEnum_t error/success
  */
-SensorEnum_t Get_Calib_Press(float *calib_data)
+SensorEnum_t Get_Calib_Press(float *calib_data, float temp)
 {
     SensorEnum_t error = GET_MEASURES_FAILED;
     uint32_t uncomp_press;
 
     if (Get_Uncompensate_Pressure(&uncomp_press) == GET_UNCOMP_MEASURES_SUCCESS)
     {
-        Write8_Flag(ADDR_I2C, REG_PWR_CNTRL, POS_PRESS, FLAG);
-
-        float partial_data1;
-        float partial_data2;
-        float partial_data3;
-        float partial_data4;
-        float partial_out1;
-        float partial_out2;
-
-        partial_data1 = coeff.nvm_p6 * coeff.comp_temp;
-        partial_data2 = coeff.nvm_p7 * (pow(coeff.comp_temp, 2));
-        partial_data3 = coeff.nvm_p8 * (pow(coeff.comp_temp, 3));
-        partial_out1 = coeff.nvm_p5 + partial_data1 + partial_data2 + partial_data3;
-
-        partial_data1 = coeff.nvm_p2 * coeff.comp_temp;
-        partial_data2 = coeff.nvm_p3 * (pow(coeff.comp_temp, 2));
-        partial_data3 = coeff.nvm_p4 * (pow(coeff.comp_temp, 3));
-        partial_out2 = uncomp_press * (coeff.nvm_p1 + partial_data1 + partial_data2 + partial_data3);
-
-        partial_data1 = pow((float)uncomp_press, 2);
-        partial_data2 = coeff.nvm_p9 + coeff.nvm_p10 * coeff.comp_temp;
-        partial_data3 = partial_data1 * partial_data2;
-        partial_data4 = partial_data3 + ((float)pow(uncomp_press, 3)) * coeff.nvm_p11;
-        *calib_data = (partial_out1 + partial_out2 + partial_data4);
+        Transport_Write_Flag(REG_PWR_CNTRL, POS_PRESS, FLAG);
+
+        *calib_data = Compensate_Pressure(uncomp_press, temp);
         error = GET_MEASURES_SUCCESS;
     }
 
     return error;
 }
 
+/**
+ * @brief Reinicialización del sensor si los fallos seguidos del bus la justifican
+ */
+static void Reinit_If_Needed()
+{
+    TransportType_t type = Get_Transport_Type();
+
+    if ((type == TRANSPORT_I2C && I2C_Needs_Reinit()) || (type == TRANSPORT_I2C_IDF && I2C_IDF_Needs_Reinit()))
+    {
+        Reinit_BMP();
+    }
+}
+
 /*************************************************** FUNCINES PÚBLICAS ***************************************************/
 
+/**
+ * @brief Compensación de una temperatura sin compensar
+ *
+ * @param uncomp_temp : lectura del registro de temperatura
+ * @return float temperatura (ºC)
+ */
+float Compensate_Temperature(uint32_t uncomp_temp)
+{
+    uint8_t slot = Buffer_Acquire(&calib_buffer);
+    float temp = Compensate_Temperature_Set(&calib_sets[slot], uncomp_temp);
+    Buffer_Release(&calib_buffer, slot);
+    return temp;
+}
+
+/**
+ * @brief Compensación de una presión sin compensar
+ *
+ * @param uncomp_press : lectura del registro de presión
+ * @param temp : temperatura compensada de la misma medida
+ * @return float presión (Pa)
+ */
+float Compensate_Pressure(uint32_t uncomp_press, float temp)
+{
+    uint8_t slot = Buffer_Acquire(&calib_buffer);
+    float press = Compensate_Pressure_Set(&calib_sets[slot], uncomp_press, temp);
+    Buffer_Release(&calib_buffer, slot);
+    return press;
+}
+
+/**
+ * @brief Selección de la precisión de la compensación
+ *
+ * @param mode : COMP_DOUBLE, COMP_FLOAT, COMP_FIXED o COMP_LUT (tras Set_Compensation_LUT)
+ */
+void Set_Compensation_Mode(CompensationMode_t mode)
+{
+    comp_mode.store(mode, std::memory_order_release);
+}
+
+/**
+ * @brief Precisión de la compensación en uso
+ *
+ * @return CompensationMode_t modo
+ */
+CompensationMode_t Get_Compensation_Mode()
+{
+    return comp_mode.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Preparación de la tabla de compensación con los coeficientes del sensor y paso a COMP_LUT
+ *
+ * La tabla se calcula entera aquí, antes de activar el modo, así que la tarea de proceso
+ * nunca la ve a medias. La tabla y su búfer deben seguir vivos mientras se use el modo.
+ *
+ * @param lut : tabla
+ * @param config : rango y tamaño de la rejilla
+ * @param table : búfer de valores
+ * @param table_len : capacidad del búfer en valores
+ * @return CompLutEnum_t error/success
+ */
+CompLutEnum_t Set_Compensation_LUT(struct CompLut *lut, const struct CompLutConfig *config, float *table,
+                                   uint32_t table_len)
+{
+    // La tabla en uso nunca se reescribe: el proceso puede estar interpolando en ella
+    const struct CompLut *live = comp_luts[lut_buffer.active.load()];
+    if (live != NULL && (live == lut || live->table == table))
+    {
+        return COMP_LUT_FAILED;
+    }
+
+    uint8_t slot = Buffer_Retired(&lut_buffer);
+    uint8_t calib_slot = Buffer_Acquire(&calib_buffer);
+    CompLutEnum_t rtrn = Init_Comp_LUT(lut, &calib_sets[calib_slot].coeff, config, table, table_len);
+    Buffer_Release(&calib_buffer, calib_slot);
+    if (rtrn != COMP_LUT_SUCCESS)
+    {
+        return COMP_LUT_FAILED;
+    }
+    comp_luts[slot] = lut;
+    lut_buffer.active.store(slot);
+    comp_mode.store(COMP_LUT, std::memory_order_release);
+    return COMP_LUT_SUCCESS;
+}
+
 /**
  * @brief Inicialización del sensor
  *
  * @return SensorEnum_t error/success
  */
 SensorEnum_t Init_BMP()
+{
+    return Init_BMP_Transport(TRANSPORT_I2C);
+}
+
+/**
+ * @brief Inicialización del sensor sobre el bus elegido
+ *
+ * @param type : i2c, spi o i2c de ESP-IDF
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Init_BMP_Transport(TransportType_t type)
 {
     SensorEnum_t rtrn;
-    I2CEnum_t rslt = Init_I2C();
-    if (rslt == I2C_SUCCESS)
+    TransportEnum_t rslt = Init_Transport(type);
+    // Sin calibración las medidas saldrían con coeficientes a cero
+    if (rslt == TRANSPORT_SUCCESS && Get_Calib_Coefficients() == GET_CALIB_DATA_SUCCESS && Enable_Measures() &&
+        Save_BMP_Config() == SAVE_CONFIG_SUCCESS)
     {
-
-        Get_Calib_Data();
-        Get_Calib_Coefficients();
-        Write8_Flag(ADDR_I2C, REG_PWR_CNTRL, 4, 1);
-        Write8_Flag(ADDR_I2C, REG_PWR_CNTRL, 5, 1);
         rtrn = INIT_SENSOR_SUCCESS;
     }
     else
@@ -318,6 +579,66 @@ SensorEnum_t Init_BMP()
     return rtrn;
 }
 
+/**
+ * @brief Reinicialización del sensor tras fallos persistentes del bus
+ *
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Reinit_BMP()
+{
+    SensorEnum_t rtrn = REINIT_SENSOR_FAILED;
+
+    // Recuperación, reinicio y recalibración sin transacciones de otras tareas en medio
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return rtrn;
+    }
+    if (Get_Transport_Type() == TRANSPORT_I2C)
+    {
+        I2C_Recover_Bus();
+    }
+    else if (Get_Transport_Type() == TRANSPORT_I2C_IDF)
+    {
+        I2C_IDF_Reset_Bus();
+    }
+    if (Transport_Write(REG_CMD, CMD_SOFT_RESET) == TRANSPORT_SUCCESS)
+    {
+        delay(RESET_DELAY_MS);
+        // El reinicio deja la configuración por defecto: se vuelve a la de la aplicación
+        if (Get_Calib_Coefficients() == GET_CALIB_DATA_SUCCESS && (config_saved ? Restore_Config() : Enable_Measures()))
+        {
+            rtrn = REINIT_SENSOR_SUCCESS;
+        }
+    }
+
+    Bus_Unlock();
+    return rtrn;
+}
+
+/**
+ * @brief Copia de la configuración (de REG_FIFO_WTM a REG_CONFIG) que restaura Reinit_BMP()
+ *
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Save_BMP_Config()
+{
+    SensorEnum_t rtrn = SAVE_CONFIG_FAILED;
+    uint8_t config[CONFIG_LEN];
+
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return rtrn;
+    }
+    if (Transport_Read(CONFIG_FIRST, config, CONFIG_LEN) == TRANSPORT_SUCCESS)
+    {
+        memcpy(config_shadow, config, CONFIG_LEN);
+        config_saved = true;
+        rtrn = SAVE_CONFIG_SUCCESS;
+    }
+    Bus_Unlock();
+    return rtrn;
+}
+
 /**
  * @brief Obtención de temperatura
  *
@@ -328,11 +649,14 @@ SensorEnum_t Get_Temp(float *temp)
 {
 
     SensorEnum_t error = GET_TEMP_FAILED;
-    if (Get_Calib_Temperature() == GET_MEASURES_SUCCESS)
+    if (Get_Calib_Temperature(temp) == GET_MEASURES_SUCCESS)
     {
-        *temp = coeff.comp_temp;
         error = GET_TEMP_SUCCESS;
     }
+    else
+    {
+        Reinit_If_Needed();
+    }
     return error;
 }
 
@@ -344,15 +668,21 @@ SensorEnum_t Get_Temp(float *temp)
  */
 SensorEnum_t Get_Press(float *press)
 {
-    float temp;
-    SensorEnum_t get_temp = Get_Temp(&temp);
+    // Sin pasar por Get_Temp(): con las dos lecturas fallidas el sensor se reinicia una sola vez
+    // Si falla la temperatura se compensa con la última medida
+    float temp = last_temp.load();
+    bool temp_ok = Get_Calib_Temperature(&temp) == GET_MEASURES_SUCCESS;
     float data;
     SensorEnum_t error = GET_PRESS_FAILED;
-    if (Get_Calib_Press(&data) == GET_MEASURES_SUCCESS)
+    if (Get_Calib_Press(&data, temp) == GET_MEASURES_SUCCESS)
     {
         *press = data;
         error = GET_PRESS_SUCCESS;
     }
+    if (!temp_ok || error != GET_PRESS_SUCCESS)
+    {
+        Reinit_If_Needed();
+    }
     return error;
 }
 
@@ -367,12 +697,14 @@ SensorEnum_t Set_Oversampling(uint8_t ovrs_p, uint8_t ovrs_t) // The “OSR” r
 {
     SensorEnum_t error = SET_OVERSAMPLING_FAILED;
     uint8_t data;
-    if (Read8_bit(REG_OSR, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_OSR, &data) == TRANSPORT_SUCCESS)
     {
         uint8_t byte = data;
         byte = byte | ovrs_p | ovrs_t << 3;
-        Write8_bit(ADDR_I2C, REG_OSR, byte);
-        error = SET_OVERSAMPLING_SUCCESS;
+        if (Write_Config(REG_OSR, byte))
+        {
+            error = SET_OVERSAMPLING_SUCCESS;
+        }
     }
     return error;
 }
@@ -387,7 +719,7 @@ SensorEnum_t Get_Oversampling(uint8_t *rslt)
 {
     uint8_t data;
     SensorEnum_t error = GET_OVERSAMPLING_FAILED;
-    if (Read8_bit(REG_OSR, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_OSR, &data) == TRANSPORT_SUCCESS)
     {
         *rslt = data;
         error = GET_OVERSAMPLING_SUCCESS;
@@ -406,12 +738,14 @@ SensorEnum_t Set_IRR_Filter(uint8_t filter) // The “CONFIG” register control
 {
     uint8_t data;
     SensorEnum_t error = SET_IRR_FILTER_FAILED;
-    if (Read8_bit(REG_CONFIG, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_CONFIG, &data) == TRANSPORT_SUCCESS)
     {
         uint8_t byte = data;
         byte = byte | filter << 1;
-        Write8_bit(ADDR_I2C, REG_CONFIG, byte);
-        error = SET_IRR_FILTER_SUCCESS;
+        if (Write_Config(REG_CONFIG, byte))
+        {
+            error = SET_IRR_FILTER_SUCCESS;
+        }
     }
     return error;
 }
@@ -426,7 +760,7 @@ SensorEnum_t Get_IRR_Filter(uint8_t *rslt)
 {
     uint8_t data;
     SensorEnum_t error = GET_IRR_FILTER_FAILED;
-    if (Read8_bit(REG_CONFIG, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_CONFIG, &data) == TRANSPORT_SUCCESS)
     {
         *rslt = data;
         error = GET_IRR_FILTER_SUCCESS;
@@ -445,12 +779,14 @@ SensorEnum_t Set_Output_Data_Rate(uint8_t rate) // The “ODR” register set th
     uint8_t data;
     SensorEnum_t error = SET_ODR_FAILED;
 
-    if (Read8_bit(REG_ODR, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_ODR, &data) == TRANSPORT_SUCCESS)
     {
         uint8_t byte = data;
         byte = byte | rate;
-        Write8_bit(ADDR_I2C, REG_ODR, byte);
-        error = SET_ODR_SUCCESS;
+        if (Write_Config(REG_ODR, byte))
+        {
+            error = SET_ODR_SUCCESS;
+        }
     }
     return error;
 }
@@ -465,7 +801,7 @@ SensorEnum_t Get_Output_Data_Rate(uint8_t *rslt)
 {
     uint8_t data;
     SensorEnum_t error = GET_ODR_FAILED;
-    if (Read8_bit(REG_ODR, ADDR_I2C, &data) == I2C_READING_BYTES_SUCCESS)
+    if (Transport_Read8(REG_ODR, &data) == TRANSPORT_SUCCESS)
     {
         *rslt = data;
         error = GET_ODR_SUCCESS;
@@ -473,3 +809,33 @@ SensorEnum_t Get_Output_Data_Rate(uint8_t *rslt)
 
     return error;
 }
+
+/**
+ * @brief Obtención del reloj interno del sensor
+ *
+ * @param time : parámetro de salida (ticks de 24 bits)
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Get_Sensor_Time(uint32_t *time)
+{
+    uint32_t data;
+    SensorEnum_t error = GET_SENSOR_TIME_FAILED;
+    if (Transport_Read24(REG_SENSORTIME, &data) == TRANSPORT_SUCCESS)
+    {
+        *time = data;
+        error = GET_SENSOR_TIME_SUCCESS;
+    }
+
+    return error;
+}
+
+/**
+ * @brief Memoria estática del driver: coeficientes y calibración
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Sensor_Footprint()
+{
+    return sizeof(calib_sets) + sizeof(calib_buffer) + sizeof(last_temp) + sizeof(comp_mode) + sizeof(comp_luts) + sizeof(lut_buffer) +
+           sizeof(config_shadow) + sizeof(config_saved);
+}
@@ -1,5 +1,10 @@
+#pragma once
+
 #include "Arduino.h"
 #include "def.h"
+#include "transport.h"
+#include "compensation.h"
+#include "comp_lut.h"
 
 /**
  * @brief Inicialización del sensor
@@ -8,6 +13,38 @@
  */
 SensorEnum_t Init_BMP();
 
+/**
+ * @brief Inicialización del sensor sobre el bus elegido
+ *
+ * @param type : i2c, spi o i2c de ESP-IDF
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Init_BMP_Transport(TransportType_t type);
+
+/**
+ * @brief Reinicialización del sensor tras fallos persistentes del bus
+ *
+ * Recupera el bus, hace un reinicio por software, vuelve a cargar la calibración y
+ * restaura la configuración copiada por Save_BMP_Config() (oversampling, filtro, ODR,
+ * FIFO, interrupciones y modo), todo con el bus tomado. Los coeficientes nuevos se
+ * publican de una vez, así que se puede llamar con la tarea de proceso compensando en
+ * el otro núcleo.
+ *
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Reinit_BMP();
+
+/**
+ * @brief Copia de la configuración (de REG_FIFO_WTM a REG_CONFIG) que restaura Reinit_BMP()
+ *
+ * Init_BMP_Transport(), los Set_* del driver y la configuración de la FIFO y de sus
+ * interrupciones (fifo.h) la actualizan solos; sólo hace falta llamarla tras escribir
+ * esos registros por otro camino.
+ *
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Save_BMP_Config();
+
 /**
  * @brief Obtención de la presión
  *
@@ -72,3 +109,66 @@ SensorEnum_t Get_Output_Data_Rate(uint8_t *rslt);
  * @return SensorEnum_t error/success
  */
 SensorEnum_t Get_Temp(float *data);
+
+/**
+ * @brief Obtención del reloj interno del sensor, para sellar las muestras
+ *
+ * @param time : parámetro de salida (ticks de 24 bits)
+ * @return SensorEnum_t error/success
+ */
+SensorEnum_t Get_Sensor_Time(uint32_t *time);
+
+/**
+ * @brief Compensación de una temperatura sin compensar
+ *
+ * @param uncomp_temp : lectura del registro de temperatura
+ * @return float temperatura (ºC)
+ */
+float Compensate_Temperature(uint32_t uncomp_temp);
+
+/**
+ * @brief Compensación de una presión sin compensar
+ *
+ * @param uncomp_press : lectura del registro de presión
+ * @param temp : temperatura compensada de la misma medida
+ * @return float presión (Pa)
+ */
+float Compensate_Pressure(uint32_t uncomp_press, float temp);
+
+/**
+ * @brief Selección de la precisión de la compensación
+ *
+ * @param mode : COMP_DOUBLE, COMP_FLOAT, COMP_FIXED o COMP_LUT (tras Set_Compensation_LUT)
+ */
+void Set_Compensation_Mode(CompensationMode_t mode);
+
+/**
+ * @brief Precisión de la compensación en uso
+ *
+ * @return CompensationMode_t modo
+ */
+CompensationMode_t Get_Compensation_Mode();
+
+/**
+ * @brief Preparación de la tabla de compensación con los coeficientes del sensor y paso a COMP_LUT
+ *
+ * La tabla se calcula entera aquí y se publica de una vez, así que la tarea de proceso
+ * nunca la ve a medias. La tabla en uso no se puede recalcular: para cambiarla se
+ * alternan dos tablas con sus búferes, y la retirada se reescribe cuando la suelta el
+ * último lector. Ambas deben seguir vivas mientras se use el modo.
+ *
+ * @param lut : tabla
+ * @param config : rango y tamaño de la rejilla
+ * @param table : búfer de valores
+ * @param table_len : capacidad del búfer en valores
+ * @return CompLutEnum_t error/success
+ */
+CompLutEnum_t Set_Compensation_LUT(struct CompLut *lut, const struct CompLutConfig *config, float *table,
+                                   uint32_t table_len);
+
+/**
+ * @brief Memoria estática del driver: coeficientes y calibración
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_Sensor_Footprint();
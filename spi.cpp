@@ -0,0 +1,148 @@
+#include "spi.h"
+#include "i2c.h"
+
+SPIClass my_spi = SPIClass(SPI_PERIPHERAL);
+
+static SPISettings spi_settings = SPISettings(SPI_CLOCK_HZ, MSBFIRST, SPI_MODE0);
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Trama de lectura con el bus tomado a la prioridad indicada
+ */
+static SPIEnum_t Read_Frame(uint8_t reg_addr, uint8_t *data, uint16_t len, BusPriority_t prio)
+{
+    if (len == 0)
+    {
+        return SPI_READING_BYTES_FAILED;
+    }
+    if (Bus_Lock(prio, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return SPI_BUS_BUSY;
+    }
+
+    my_spi.beginTransaction(spi_settings);
+    digitalWrite(CS_SPI, LOW);
+    my_spi.transfer(reg_addr | SPI_READ_BIT);
+    my_spi.transfer(0x00); // Byte de relleno
+    my_spi.transferBytes(NULL, data, len);
+    digitalWrite(CS_SPI, HIGH);
+    my_spi.endTransaction();
+
+    Bus_Unlock();
+    return SPI_READING_BYTES_SUCCESS;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/*!
+ * @brief Inicialización del spi. Un flanco en CS pasa el sensor de modo i2c a spi.
+ * Las tramas pasan por el gestor del bus, igual que las de i2c.
+ * @return SPIEnum_t error/success
+ */
+SPIEnum_t Init_SPI()
+{
+    SPIEnum_t rtrn = SPI_FAILED;
+    uint8_t chip_id;
+
+    if (Init_Bus() != BUS_LOCK_SUCCESS)
+    {
+        return rtrn;
+    }
+    pinMode(CS_SPI, OUTPUT);
+    digitalWrite(CS_SPI, HIGH);
+    my_spi.begin(SCK_SPI, MISO_SPI, MOSI_SPI, CS_SPI);
+
+    // La primera lectura sólo sirve para cambiar de interfaz
+    SPI_Read_Bytes(REG_CHIP_ID, &chip_id, 1);
+    if (SPI_Read_Bytes(REG_CHIP_ID, &chip_id, 1) == SPI_READING_BYTES_SUCCESS && chip_id == CHIP_ID)
+    {
+        rtrn = SPI_SUCCESS;
+    }
+    return rtrn;
+}
+
+/**
+ * @brief Lectura de varios registros consecutivos
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Read_Bytes(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return Read_Frame(reg_addr, data, len, BUS_PRIO_HIGH);
+}
+
+/**
+ * @brief Lectura en ráfaga de baja prioridad (descargas de FIFO)
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Read_Bulk(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return Read_Frame(reg_addr, data, len, BUS_PRIO_LOW);
+}
+
+/*!
+ * @brief Escritura en registros de 8 bits
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] data : dato que escribimos en el registro
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Write8_bit(uint8_t reg_addr, uint8_t data)
+{
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return SPI_BUS_BUSY;
+    }
+
+    my_spi.beginTransaction(spi_settings);
+    digitalWrite(CS_SPI, LOW);
+    my_spi.transfer(reg_addr & ~SPI_READ_BIT);
+    my_spi.transfer(data);
+    digitalWrite(CS_SPI, HIGH);
+    my_spi.endTransaction();
+
+    Bus_Unlock();
+    return SPI_SUCCESS;
+}
+
+/*!
+ * @brief Escritura por bandera en registro
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] pos : posición a cambiar
+ * @param[in] value : valor del bit
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Write8_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value)
+{
+    uint8_t value_byte;
+    SPIEnum_t rslt = SPI_FAILED;
+
+    // Lectura-modificación-escritura atómica respecto a otras tareas
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return SPI_BUS_BUSY;
+    }
+    if (SPI_Read_Bytes(reg_addr, &value_byte, 1) == SPI_READING_BYTES_SUCCESS)
+    {
+        rslt = SPI_Write8_bit(reg_addr, Set_Binary(value_byte, value, pos));
+    }
+    Bus_Unlock();
+    return rslt;
+}
+
+/**
+ * @brief Memoria estática del backend spi
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_SPI_Footprint()
+{
+    return sizeof(my_spi) + sizeof(spi_settings);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "bus.h"
+#include "def.h"
+
+// Frecuencia del SPI (máximo del BMP388: 10 MHz)
+#define SPI_CLOCK_HZ            10000000
+
+// Bit de lectura en la dirección de registro
+#define SPI_READ_BIT            0x80
+
+// Periférico SPI: VSPI en el ESP32; el S2, S3 y C3 no lo tienen y su SPI de uso general es FSPI
+#ifdef VSPI
+#define SPI_PERIPHERAL          VSPI
+#else
+#define SPI_PERIPHERAL          FSPI
+#endif
+
+typedef enum
+{
+    SPI_FAILED = 0,
+    SPI_SUCCESS,
+    SPI_READING_BYTES_SUCCESS,
+    SPI_READING_BYTES_FAILED,
+    SPI_BUS_BUSY // No se ha podido tomar el bus a tiempo
+} SPIEnum_t;
+
+// Funciones spi
+
+/*!
+ * @brief Inicialización del spi. Un flanco en CS pasa el sensor de modo i2c a spi.
+ * Las tramas pasan por el gestor del bus, igual que las de i2c.
+ * @return SPIEnum_t error/success
+ */
+SPIEnum_t Init_SPI();
+
+/**
+ * @brief Lectura de varios registros consecutivos
+ *
+ * La trama es: dirección con el bit de lectura, un byte de relleno y los datos.
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Read_Bytes(uint8_t reg_addr, uint8_t *data, uint16_t len);
+
+/**
+ * @brief Lectura en ráfaga de baja prioridad (descargas de FIFO)
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Read_Bulk(uint8_t reg_addr, uint8_t *data, uint16_t len);
+
+/*!
+ * @brief Escritura en registros de 8 bits
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] data : dato que escribimos en el registro
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Write8_bit(uint8_t reg_addr, uint8_t data);
+
+/*!
+ * @brief Escritura por bandera en registro
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] pos : posición a cambiar
+ * @param[in] value : valor del bit
+ * @return SPIEnum_t Error
+ */
+SPIEnum_t SPI_Write8_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value);
+
+/**
+ * @brief Memoria estática del backend spi
+ *
+ * @return uint32_t bytes
+ */
+uint32_t Get_SPI_Footprint();
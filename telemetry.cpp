@@ -0,0 +1,247 @@
+#include "telemetry.h"
+#include "string.h"
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+static void Put_U16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = value & 0xFF;
+    buf[1] = value >> 8;
+}
+
+static void Put_U32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = value & 0xFF;
+    buf[1] = (value >> 8) & 0xFF;
+    buf[2] = (value >> 16) & 0xFF;
+    buf[3] = value >> 24;
+}
+
+static uint16_t Get_U16(const uint8_t *buf)
+{
+    return buf[0] | (buf[1] << 8);
+}
+
+static uint32_t Get_U32(const uint8_t *buf)
+{
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static void Put_Float(uint8_t *buf, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Put_U32(buf, bits);
+}
+
+static float Get_Float(const uint8_t *buf)
+{
+    uint32_t bits = Get_U32(buf);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Codificación COBS
+ *
+ * @return uint16_t bytes escritos, sin delimitador
+ */
+static uint16_t COBS_Encode(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t code_idx = 0;
+    uint16_t out_idx = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (in[i] == 0)
+        {
+            out[code_idx] = code;
+            code_idx = out_idx++;
+            code = 1;
+        }
+        else
+        {
+            out[out_idx++] = in[i];
+            code++;
+            if (code == 0xFF)
+            {
+                out[code_idx] = code;
+                code_idx = out_idx++;
+                code = 1;
+            }
+        }
+    }
+    out[code_idx] = code;
+    return out_idx;
+}
+
+/**
+ * @brief Decodificación COBS
+ *
+ * @return uint16_t bytes decodificados, 0 si la trama es inválida
+ */
+static uint16_t COBS_Decode(const uint8_t *in, uint16_t len, uint8_t *out, uint16_t out_size)
+{
+    uint16_t in_idx = 0;
+    uint16_t out_idx = 0;
+
+    while (in_idx < len)
+    {
+        uint8_t code = in[in_idx++];
+        if (code == 0 || in_idx + code - 1 > len)
+        {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (out_idx >= out_size)
+            {
+                return 0;
+            }
+            out[out_idx++] = in[in_idx++];
+        }
+        if (code != 0xFF && in_idx < len)
+        {
+            if (out_idx >= out_size)
+            {
+                return 0;
+            }
+            out[out_idx++] = 0;
+        }
+    }
+    return out_idx;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ *
+ * @param data : datos
+ * @param len : número de bytes
+ * @return uint16_t crc
+ */
+uint16_t Telemetry_CRC16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Inicialización del codificador
+ *
+ * @param enc : codificador
+ */
+void Init_Telemetry(struct TelemetryEncoder *enc)
+{
+    enc->count = 0;
+    enc->seq = 0;
+}
+
+/**
+ * @brief Añade una muestra a la trama en curso
+ *
+ * @param enc : codificador
+ * @param sample : muestra
+ * @return TelemetryEnum_t TELEMETRY_FRAME_FULL si la trama ya no admite más muestras
+ */
+TelemetryEnum_t Telemetry_Add_Sample(struct TelemetryEncoder *enc, const struct TelemetrySample *sample)
+{
+    if (enc->count >= TELEMETRY_MAX_SAMPLES)
+    {
+        return TELEMETRY_FRAME_FULL;
+    }
+
+    uint8_t *ptr = &enc->raw[TELEMETRY_HEADER_SIZE + enc->count * TELEMETRY_SAMPLE_SIZE];
+    Put_U32(ptr, sample->sensor_time);
+    Put_Float(ptr + 4, sample->press);
+    Put_Float(ptr + 8, sample->temp);
+    enc->count++;
+
+    return enc->count >= TELEMETRY_MAX_SAMPLES ? TELEMETRY_FRAME_FULL : TELEMETRY_SUCCESS;
+}
+
+/**
+ * @brief Cierra la trama en curso: CRC, COBS y delimitador
+ *
+ * @param enc : codificador, queda listo para la siguiente trama
+ * @param out : buffer de salida de al menos TELEMETRY_FRAME_SIZE bytes
+ * @param out_len : bytes escritos
+ * @return TelemetryEnum_t error/success
+ */
+TelemetryEnum_t Telemetry_Encode(struct TelemetryEncoder *enc, uint8_t *out, uint16_t *out_len)
+{
+    if (enc->count == 0)
+    {
+        *out_len = 0;
+        return TELEMETRY_FAILED;
+    }
+
+    uint16_t raw_len = TELEMETRY_HEADER_SIZE + enc->count * TELEMETRY_SAMPLE_SIZE;
+    enc->raw[0] = TELEMETRY_VERSION;
+    Put_U16(&enc->raw[1], enc->seq);
+    enc->raw[3] = enc->count;
+    Put_U16(&enc->raw[raw_len], Telemetry_CRC16(enc->raw, raw_len));
+    raw_len += TELEMETRY_CRC_SIZE;
+
+    uint16_t len = COBS_Encode(enc->raw, raw_len, out);
+    out[len++] = 0x00;
+    *out_len = len;
+
+    enc->seq++;
+    enc->count = 0;
+    return TELEMETRY_SUCCESS;
+}
+
+/**
+ * @brief Decodifica una trama COBS sin el delimitador final
+ *
+ * @param in : bytes recibidos entre dos ceros
+ * @param in_len : número de bytes
+ * @param frame : parámetro de salida
+ * @return TelemetryEnum_t error/success/crc
+ */
+TelemetryEnum_t Telemetry_Decode(const uint8_t *in, uint16_t in_len, struct TelemetryFrame *frame)
+{
+    uint8_t raw[TELEMETRY_RAW_SIZE];
+    uint16_t raw_len = COBS_Decode(in, in_len, raw, sizeof(raw));
+
+    if (raw_len < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE || raw[0] != TELEMETRY_VERSION)
+    {
+        return TELEMETRY_FAILED;
+    }
+
+    uint8_t count = raw[3];
+    if (count > TELEMETRY_MAX_SAMPLES ||
+        raw_len != TELEMETRY_HEADER_SIZE + count * TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+    {
+        return TELEMETRY_FAILED;
+    }
+
+    if (Telemetry_CRC16(raw, raw_len - TELEMETRY_CRC_SIZE) != Get_U16(&raw[raw_len - TELEMETRY_CRC_SIZE]))
+    {
+        return TELEMETRY_CRC_ERROR;
+    }
+
+    frame->seq = Get_U16(&raw[1]);
+    frame->count = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const uint8_t *ptr = &raw[TELEMETRY_HEADER_SIZE + i * TELEMETRY_SAMPLE_SIZE];
+        frame->samples[i].sensor_time = Get_U32(ptr);
+        frame->samples[i].press = Get_Float(ptr + 4);
+        frame->samples[i].temp = Get_Float(ptr + 8);
+    }
+    return TELEMETRY_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/*
+ * Trama binaria de telemetría (antes de COBS, little endian):
+ *
+ *   [versión:1][secuencia:2][n:1] n x [sensortime:4][presión:4 float][temperatura:4 float] [crc16:2]
+ *
+ * El CRC es CRC-16/CCITT-FALSE sobre todo lo anterior. La trama se codifica con COBS y
+ * se termina con un 0x00, de modo que el receptor se resincroniza en el siguiente cero.
+ */
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_HEADER_SIZE   4
+#define TELEMETRY_SAMPLE_SIZE   12
+#define TELEMETRY_CRC_SIZE      2
+#ifndef TELEMETRY_MAX_SAMPLES
+#define TELEMETRY_MAX_SAMPLES   20
+#endif
+// El número de muestras viaja en un byte de la cabecera
+static_assert(TELEMETRY_MAX_SAMPLES <= 255, "TELEMETRY_MAX_SAMPLES no cabe en el byte n de la cabecera");
+
+// Tamaño de la trama sin codificar; con 20 muestras cabe en un solo bloque COBS (< 254)
+#define TELEMETRY_RAW_SIZE      (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_SAMPLES * TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+
+// Tamaño máximo codificado: COBS añade un byte cada 254 más el delimitador
+#define TELEMETRY_FRAME_SIZE    (TELEMETRY_RAW_SIZE + TELEMETRY_RAW_SIZE / 254 + 2)
+
+typedef enum
+{
+    TELEMETRY_FAILED = 0,
+    TELEMETRY_SUCCESS,
+    TELEMETRY_FRAME_FULL,
+    TELEMETRY_CRC_ERROR
+} TelemetryEnum_t;
+
+/*! Muestra transmitida */
+struct TelemetrySample
+{
+    uint32_t sensor_time;
+    float press;
+    float temp;
+};
+
+/*! Codificador: la trama se construye en su propio buffer, sin memoria dinámica */
+struct TelemetryEncoder
+{
+    uint8_t raw[TELEMETRY_RAW_SIZE];
+    uint8_t count;
+    uint16_t seq;
+};
+
+/*! Trama decodificada */
+struct TelemetryFrame
+{
+    uint16_t seq;
+    uint8_t count;
+    struct TelemetrySample samples[TELEMETRY_MAX_SAMPLES];
+};
+
+/**
+ * @brief Inicialización del codificador
+ *
+ * @param enc : codificador
+ */
+void Init_Telemetry(struct TelemetryEncoder *enc);
+
+/**
+ * @brief Añade una muestra a la trama en curso
+ *
+ * @param enc : codificador
+ * @param sample : muestra
+ * @return TelemetryEnum_t TELEMETRY_FRAME_FULL si la trama ya no admite más muestras
+ */
+TelemetryEnum_t Telemetry_Add_Sample(struct TelemetryEncoder *enc, const struct TelemetrySample *sample);
+
+/**
+ * @brief Cierra la trama en curso: CRC, COBS y delimitador
+ *
+ * @param enc : codificador, queda listo para la siguiente trama
+ * @param out : buffer de salida de al menos TELEMETRY_FRAME_SIZE bytes
+ * @param out_len : bytes escritos
+ * @return TelemetryEnum_t error/success
+ */
+TelemetryEnum_t Telemetry_Encode(struct TelemetryEncoder *enc, uint8_t *out, uint16_t *out_len);
+
+/**
+ * @brief Decodifica una trama COBS sin el delimitador final
+ *
+ * @param in : bytes recibidos entre dos ceros
+ * @param in_len : número de bytes
+ * @param frame : parámetro de salida
+ * @return TelemetryEnum_t error/success/crc
+ */
+TelemetryEnum_t Telemetry_Decode(const uint8_t *in, uint16_t in_len, struct TelemetryFrame *frame);
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ *
+ * @param data : datos
+ * @param len : número de bytes
+ * @return uint16_t crc
+ */
+uint16_t Telemetry_CRC16(const uint8_t *data, uint16_t len);
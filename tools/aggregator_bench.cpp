@@ -0,0 +1,73 @@
+/*
+ * Coste por muestra del agregador de estadísticas en el host.
+ *
+ * Alimenta cada configuración con una serie sintética de presión y temperatura y
+ * muestra los ns por muestra y los resúmenes entregados. Para el coste en el ESP32,
+ * el mismo bucle puede ejecutarse en la placa midiendo con micros().
+ *
+ * Compilación: g++ -O2 -I.. aggregator_bench.cpp ../aggregator.cpp -o aggregator_bench
+ * Uso:         aggregator_bench [muestras]
+ */
+#include "aggregator.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "math.h"
+#include <chrono>
+#include <vector>
+
+#define BENCH_SAMPLES 1000000
+
+static uint32_t summaries;
+
+static void Count_Summary(const struct AggSummary *summary, void *user)
+{
+    (void)summary;
+    (void)user;
+    summaries++;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t samples = argc > 1 ? strtoul(argv[1], NULL, 0) : BENCH_SAMPLES;
+    if (samples == 0)
+    {
+        fprintf(stderr, "uso: %s [muestras]\n", argv[0]);
+        return 1;
+    }
+
+    // Presión con deriva lenta y ruido, temperatura casi constante
+    std::vector<float> press(samples);
+    std::vector<float> temp(samples);
+    srand(1);
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        press[i] = 101325.0f + 50.0f * sinf(i * 0.001f) + (rand() % 1000) / 100.0f;
+        temp[i] = 25.0f + (rand() % 100) / 100.0f;
+    }
+
+    const struct AggConfig configs[] = {
+        {AGG_TUMBLING, 50, 0, Count_Summary, NULL},
+        {AGG_TUMBLING, AGG_MAX_WINDOW, 0, Count_Summary, NULL},
+        {AGG_SLIDING, 50, 10, Count_Summary, NULL},
+        {AGG_SLIDING, AGG_MAX_WINDOW, 1, Count_Summary, NULL},
+    };
+    static struct Aggregator agg;
+
+    printf("ventana,muestras,salto,ns_muestra,resumenes\n");
+    for (const struct AggConfig &config : configs)
+    {
+        Init_Aggregator(&agg, &config);
+        summaries = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            Aggregator_Add(&agg, press[i], temp[i], i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        printf("%s,%u,%u,%.1f,%u\n", config.type == AGG_SLIDING ? "deslizante" : "fija", config.window,
+               agg.config.hop, elapsed.count() / samples, summaries);
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * Prueba en el host de que el camino caliente del pipeline no reserva memoria.
+ *
+ * Sustituye malloc, calloc, realloc y new por versiones que cuentan las llamadas
+ * mientras la ventana de medida está abierta. Arranca el pipeline en ráfaga y por
+ * FIFO con agregador, eventos y comprobación de salud, deja pasar los primeros ciclos
+ * (el sustituto de FreeRTOS crea sus hilos con new al arrancar, cosa que en el ESP32
+ * hace xTaskCreateStaticPinnedToCore sin reservar) y cuenta las reservas durante
+ * ALLOC_WINDOW_MS de adquisición y proceso. Dentro de la ventana el hilo principal
+ * sólo duerme. Termina con código distinto de cero si hay alguna reserva.
+ *
+ * Compilación: g++ -O2 -pthread -Ihost -I.. alloc_test.cpp host/host.cpp host/wire.cpp host/spi.cpp host/sim_bmp388.cpp
+ *              ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp ../transport.cpp ../sensor.cpp ../compensation.cpp
+ *              ../comp_lut.cpp ../fifo.cpp ../ring.cpp ../pipeline.cpp ../aggregator.cpp ../events.cpp ../health.cpp
+ *              -o alloc_test
+ */
+#include "pipeline.h"
+#include "fifo.h"
+#include "sensor.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <atomic>
+#include <new>
+
+#define ALLOC_WARMUP_MS     50
+#define ALLOC_WINDOW_MS     500
+#define ALLOC_PERIOD_MS     2
+#define ALLOC_FIFO_FRAMES   4 // Tramas que añade el sensor simulado en cada periodo
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+static std::atomic<bool> counting(false);
+static std::atomic<uint32_t> allocations(0);
+static std::atomic<bool> feeding(false);
+static std::atomic<uint32_t> outputs(0);
+static int failures = 0;
+
+/*************************************************** SUSTITUTOS DEL ASIGNADOR ***************************************************/
+
+static void Count_Allocation()
+{
+    if (counting)
+    {
+        allocations++;
+    }
+}
+
+extern "C" void *malloc(size_t size)
+{
+    Count_Allocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    Count_Allocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    Count_Allocation();
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+void *operator new(size_t size)
+{
+    Count_Allocation();
+    void *ptr = __libc_malloc(size > 0 ? size : 1);
+    if (ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    __libc_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    __libc_free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept
+{
+    (void)size;
+    __libc_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t size) noexcept
+{
+    (void)size;
+    __libc_free(ptr);
+}
+
+/*************************************************** PRUEBA ***************************************************/
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Sensor simulado produciendo tramas en la FIFO a ritmo constante
+ */
+static void *Feeder(void *arg)
+{
+    (void)arg;
+    while (feeding)
+    {
+        Sim_BMP388_Fill_Fifo(ALLOC_FIFO_FRAMES);
+        usleep(ALLOC_PERIOD_MS * 1000);
+    }
+    return NULL;
+}
+
+static void Count_Output(const struct PipelineSample *sample, void *user)
+{
+    (void)sample;
+    (void)user;
+    outputs++;
+}
+
+static void Count_Summary(const struct AggSummary *summary, void *user)
+{
+    (void)summary;
+    (void)user;
+}
+
+static void Count_Event(const struct EventInfo *info, void *user)
+{
+    (void)info;
+    (void)user;
+}
+
+static void Run_Pipeline(const char *name, PipelineSource_t source)
+{
+    static struct Aggregator aggregator;
+    static struct EventEngine events;
+    static struct HealthMonitor health;
+    struct AggConfig agg_config = {AGG_SLIDING, 16, 4, Count_Summary, NULL};
+    struct EventRule rule = {EVENT_PRESS_ABOVE, 0.0f, 1.0f, Count_Event, NULL};
+    struct PipelineConfig config = {};
+    struct PipelineStats stats;
+    pthread_t feeder;
+
+    Check(Init_Aggregator(&aggregator, &agg_config) == AGG_SUCCESS, "Init_Aggregator");
+    Init_Event_Engine(&events, EVENT_RATE_WINDOW_US);
+    Check(Event_Add_Rule(&events, &rule) == EVENT_SUCCESS, "Event_Add_Rule");
+    Check(Init_Health_Monitor(&health, HEALTH_STUCK_SAMPLES, ALLOC_PERIOD_MS * 5) == HEALTH_SUCCESS,
+          "Init_Health_Monitor");
+
+    config.source = source;
+    config.period_ms = ALLOC_PERIOD_MS;
+    config.acq_core = PIPELINE_ACQ_CORE;
+    config.proc_core = PIPELINE_PROC_CORE;
+    config.filter_alpha = 0.5f;
+    config.output = Count_Output;
+    config.aggregator = &aggregator;
+    config.events = &events;
+    config.health = &health;
+    outputs = 0;
+
+    if (source == PIPELINE_FIFO)
+    {
+        Flush_FIFO();
+    }
+    feeding = source == PIPELINE_FIFO;
+    pthread_create(&feeder, NULL, Feeder, NULL);
+    Check(Start_Pipeline(&config) == PIPELINE_SUCCESS, "Start_Pipeline");
+    usleep(ALLOC_WARMUP_MS * 1000);
+
+    allocations = 0;
+    uint32_t before = outputs;
+    counting = true;
+    usleep(ALLOC_WINDOW_MS * 1000);
+    counting = false;
+    uint32_t during = outputs - before;
+
+    Stop_Pipeline();
+    feeding = false;
+    pthread_join(feeder, NULL);
+    Get_Pipeline_Stats(&stats);
+
+    printf("%-8s %6u muestras en la ventana, %u reservas\n", name, during, allocations.load());
+    Check(stats.bus_errors == 0, "lecturas fallidas en el pipeline");
+    Check(during > 0, "muestras procesadas en la ventana");
+    Check(allocations == 0, "reservas en el camino caliente");
+}
+
+int main()
+{
+    Sim_BMP388_Power_On();
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport");
+
+    Run_Pipeline("ráfaga", PIPELINE_BURST);
+    Run_Pipeline("FIFO", PIPELINE_FIFO);
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
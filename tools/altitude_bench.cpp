@@ -0,0 +1,129 @@
+/*
+ * Caracterización de la altitud por tabla en el host.
+ *
+ * Barre la presión de 300 a 1250 hPa con varios QNH entre 930 y 1200 hPa y compara
+ * la tabla (Get_Altitude y Get_Altitude_Batch) y la fórmula con powf con la
+ * referencia en double: error máximo y RMS en m y tiempo por muestra en ns.
+ * Termina con código distinto de cero si el error de la tabla supera el documentado
+ * en altitude.h.
+ *
+ * Compilación: g++ -O2 -I.. altitude_bench.cpp ../altitude.cpp -o altitude_bench
+ */
+#include "altitude.h"
+#include "stdio.h"
+#include "math.h"
+#include <chrono>
+#include <vector>
+
+#define BENCH_PRESS_MIN     30000.0
+#define BENCH_PRESS_MAX     125000.0
+#define BENCH_PRESS_STEPS   4096
+#define BENCH_QNH_MIN       93000.0
+#define BENCH_QNH_MAX       120000.0
+#define BENCH_QNH_STEPS     8
+#define BENCH_ROUNDS        50
+#define BENCH_MAX_ERROR_M   0.2 // Error documentado en altitude.h
+
+struct BenchResult
+{
+    double max_error;
+    double sum_error2;
+    double ns_per_sample;
+};
+
+static volatile float sink;
+
+static double Reference(double press, double qnh)
+{
+    return ALTITUDE_SCALE_M * (1.0 - pow(press / qnh, ALTITUDE_EXPONENT));
+}
+
+static double Elapsed_ns(std::chrono::steady_clock::time_point start, size_t samples)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / samples;
+}
+
+static void Add_Error(struct BenchResult *result, double error)
+{
+    error = fabs(error);
+    if (error > result->max_error)
+    {
+        result->max_error = error;
+    }
+    result->sum_error2 += error * error;
+}
+
+int main()
+{
+    struct AltitudeState state;
+    std::vector<float> press(BENCH_PRESS_STEPS);
+    std::vector<uint32_t> time_us(BENCH_PRESS_STEPS);
+    std::vector<struct AltitudeSample> out(BENCH_PRESS_STEPS);
+    struct BenchResult result[3] = {};
+    const char *names[3] = {"powf", "tabla", "tabla por lotes"};
+    size_t samples = 0;
+
+    for (uint16_t i = 0; i < BENCH_PRESS_STEPS; i++)
+    {
+        press[i] = BENCH_PRESS_MIN + (BENCH_PRESS_MAX - BENCH_PRESS_MIN) * i / (BENCH_PRESS_STEPS - 1);
+        time_us[i] = i * 10000;
+    }
+
+    for (uint8_t q = 0; q < BENCH_QNH_STEPS; q++)
+    {
+        float qnh = BENCH_QNH_MIN + (BENCH_QNH_MAX - BENCH_QNH_MIN) * q / (BENCH_QNH_STEPS - 1);
+        Init_Altitude(&state, qnh, qnh, 1.0f);
+        Get_Altitude_Batch(&state, press.data(), time_us.data(), out.data(), BENCH_PRESS_STEPS);
+
+        for (uint16_t i = 0; i < BENCH_PRESS_STEPS; i++)
+        {
+            double reference = Reference(press[i], qnh);
+            Add_Error(&result[0], Get_Altitude_Exact(press[i], qnh) - reference);
+            Add_Error(&result[1], Get_Altitude(press[i], qnh) - reference);
+            Add_Error(&result[2], out[i].altitude - reference);
+        }
+        samples += BENCH_PRESS_STEPS;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            for (uint16_t i = 0; i < BENCH_PRESS_STEPS; i++)
+            {
+                sink = Get_Altitude_Exact(press[i], qnh);
+            }
+        }
+        result[0].ns_per_sample += Elapsed_ns(start, BENCH_ROUNDS * BENCH_PRESS_STEPS) / BENCH_QNH_STEPS;
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            for (uint16_t i = 0; i < BENCH_PRESS_STEPS; i++)
+            {
+                sink = Get_Altitude(press[i], qnh);
+            }
+        }
+        result[1].ns_per_sample += Elapsed_ns(start, BENCH_ROUNDS * BENCH_PRESS_STEPS) / BENCH_QNH_STEPS;
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            Get_Altitude_Batch(&state, press.data(), time_us.data(), out.data(), BENCH_PRESS_STEPS);
+            sink = out[BENCH_PRESS_STEPS - 1].altitude;
+        }
+        result[2].ns_per_sample += Elapsed_ns(start, BENCH_ROUNDS * BENCH_PRESS_STEPS) / BENCH_QNH_STEPS;
+    }
+
+    printf("%zu muestras, %d QNH entre %.0f y %.0f hPa\n", samples, BENCH_QNH_STEPS, BENCH_QNH_MIN / 100,
+           BENCH_QNH_MAX / 100);
+    printf("%-16s %12s %12s %10s\n", "modo", "máx (m)", "RMS (m)", "ns/muestra");
+    for (int m = 0; m < 3; m++)
+    {
+        printf("%-16s %12.4f %12.4f %10.2f\n", names[m], result[m].max_error, sqrt(result[m].sum_error2 / samples),
+               result[m].ns_per_sample);
+    }
+
+    bool ok = result[1].max_error <= BENCH_MAX_ERROR_M && result[2].max_error <= BENCH_MAX_ERROR_M;
+    printf(ok ? "OK\n" : "FALLO: error de la tabla por encima de %.1f m\n", BENCH_MAX_ERROR_M);
+    return ok ? 0 : 1;
+}
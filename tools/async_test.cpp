@@ -0,0 +1,212 @@
+/*
+ * Prueba en el host del ejecutor asíncrono sobre dos BMP388 simulados en el mismo i2c
+ * (ADDR_I2C y ADDR_I2C_ALT).
+ *
+ * Comprueba que Async_Run duerme la tarea durante la conversión en vez de esperar en
+ * activo, que un ejecutor atiende dos sensores con sus propios coeficientes, que la
+ * medida deja PWR_CTRL como estaba (sleep con otros canales o modo normal), que una
+ * medida y una descarga de la FIFO del mismo sensor no se intercalan en el bus, el número
+ * de transacciones de una medida y la capa de corrutinas. Termina con código distinto
+ * de cero si algo falla.
+ *
+ * Compilación: g++ -std=c++20 -O2 -pthread -Ihost -I.. async_test.cpp host/host.cpp host/wire.cpp host/spi.cpp
+ *              host/sim_bmp388.cpp ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp ../transport.cpp ../sensor.cpp
+ *              ../compensation.cpp ../comp_lut.cpp ../fifo.cpp ../async.cpp -o async_test
+ */
+#include "async.h"
+#include "async_co.h"
+#include "sensor.h"
+#include "i2c.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+#include "time.h"
+
+#define TEST_RAW_PRESS_ALT  6000000 // Lectura del segundo sensor, distinta de la del primero
+#define TEST_FIFO_FRAMES    20
+#define TEST_LOG            64
+#define TEST_MAX_CPU        0.3 // Fracción de CPU admitida durante Async_Run
+#define TEST_MEASURE_TRANS  7   // PWR_CTRL+OSR, modo forzado, STATUS y ráfaga de datos
+
+static int failures = 0;
+
+// Registros a los que accede el sensor 0 por el bus con registro
+static uint8_t bus_log[TEST_LOG];
+static uint8_t bus_log_len = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+static double Cpu_Us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void Log(uint8_t reg_addr)
+{
+    if (bus_log_len < TEST_LOG)
+    {
+        bus_log[bus_log_len++] = reg_addr;
+    }
+}
+
+static TransportEnum_t Logged_Read(void *ctx, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    Log(reg_addr);
+    return Transport_Read(reg_addr, data, len);
+}
+
+static TransportEnum_t Logged_Write(void *ctx, uint8_t reg_addr, uint8_t data)
+{
+    (void)ctx;
+    Log(reg_addr);
+    return Transport_Write(reg_addr, data);
+}
+
+/**
+ * @brief Medida síncrona de referencia con la misma compensación que el ejecutor
+ */
+static float Expected_Press(const struct AsyncSensor *sensor, uint32_t uncomp_press, uint32_t uncomp_temp)
+{
+    float temp = Compensate_Temperature_Float(&sensor->coeff, uncomp_temp);
+    return Compensate_Pressure_Float(&sensor->coeff, uncomp_press, temp);
+}
+
+static AsyncCoroutine Measure_Then_Drain(AsyncSensorCo *sensor, uint8_t *raw, struct FifoSample *samples,
+                                         struct AsyncTask *measure, struct AsyncTask *drain)
+{
+    *measure = co_await sensor->measure();
+    *drain = co_await sensor->drain_fifo(raw, samples, TEST_FIFO_FRAMES);
+}
+
+int main()
+{
+    struct AsyncExecutor exec;
+    struct AsyncSensor sensor[2];
+    struct AsyncBus bus;
+    struct AsyncTask task[2];
+    static uint8_t raw[2][FIFO_MAX_BYTES];
+    static struct FifoSample samples[2][TEST_FIFO_FRAMES];
+
+    Sim_BMP388_Select(1);
+    Sim_BMP388_Power_On();
+    Sim_BMP388_Set_Raw(TEST_RAW_PRESS_ALT, SIM_BMP388_RAW_TEMP);
+    Sim_BMP388_Select(0);
+    Sim_BMP388_Power_On();
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport");
+    // Init_BMP_Transport deja el sensor en modo normal; las medidas parten de sleep
+    Transport_Write(REG_PWR_CNTRL, PWR_PRESS_EN | PWR_TEMP_EN | MODE_SLEEP);
+
+    bus.read = Logged_Read;
+    bus.write = Logged_Write;
+    bus.ctx = NULL;
+    Check(Init_Async_Sensor(&sensor[0], &bus) == ASYNC_DONE, "Init_Async_Sensor en ADDR_I2C");
+    Async_I2C_Bus(&bus, ADDR_I2C_ALT);
+    Check(Init_Async_Sensor(&sensor[1], &bus) == ASYNC_DONE, "Init_Async_Sensor en ADDR_I2C_ALT");
+    Init_Async_Executor(&exec);
+    Check(Async_Run_Once(&exec) == ASYNC_NO_WAKE, "ejecutor vacío sin instante de sondeo");
+
+    // Dos sensores en un ejecutor, que duerme durante la conversión
+    Async_Measure(&task[0], &sensor[0], NULL, NULL);
+    Async_Measure(&task[1], &sensor[1], NULL, NULL);
+    Async_Submit(&exec, &task[0]);
+    Async_Submit(&exec, &task[1]);
+    uint32_t wait_us = Async_Run_Once(&exec);
+    Check(wait_us > ASYNC_POLL_US && wait_us != ASYNC_NO_WAKE, "espera hasta el fin de la conversión");
+    uint32_t start = micros();
+    double cpu = Cpu_Us();
+    Async_Run(&exec);
+    cpu = Cpu_Us() - cpu;
+    uint32_t wall = micros() - start;
+    printf("dos medidas: %u us, %.0f us de CPU\n", wall, cpu);
+    Check(cpu < TEST_MAX_CPU * wall, "Async_Run no espera en activo");
+    Check(task[0].status == ASYNC_DONE && task[1].status == ASYNC_DONE, "dos medidas terminadas");
+    Check(task[0].press == Expected_Press(&sensor[0], SIM_BMP388_RAW_PRESS, SIM_BMP388_RAW_TEMP),
+          "presión del sensor 0");
+    Check(task[1].press == Expected_Press(&sensor[1], TEST_RAW_PRESS_ALT, SIM_BMP388_RAW_TEMP),
+          "presión del sensor 1");
+    printf("sensor 0: %.2f Pa, sensor 1: %.2f Pa\n", task[0].press, task[1].press);
+
+    // Transacciones de una medida desde sleep con los dos canales
+    uint32_t trans = Host_Wire_Transactions();
+    Async_Measure(&task[0], &sensor[0], NULL, NULL);
+    Async_Submit(&exec, &task[0]);
+    Async_Run(&exec);
+    trans = Host_Wire_Transactions() - trans;
+    printf("transacciones por medida: %u\n", trans);
+    Check(trans == TEST_MEASURE_TRANS, "transacciones por medida");
+
+    // Sleep con sólo la presión: vuelve igual
+    Transport_Write(REG_PWR_CNTRL, PWR_PRESS_EN | MODE_SLEEP);
+    Async_Measure(&task[0], &sensor[0], NULL, NULL);
+    Async_Submit(&exec, &task[0]);
+    Async_Run(&exec);
+    Check(task[0].status == ASYNC_DONE, "medida con sólo la presión habilitada");
+    Check(Sim_BMP388_Peek(REG_PWR_CNTRL) == (PWR_PRESS_EN | MODE_SLEEP), "PWR_CTRL restaurado tras la medida");
+
+    // Modo normal: la medida no lo detiene ni dispara conversiones forzadas
+    struct SimBmp388Stats sim;
+    Transport_Write(REG_PWR_CNTRL, PWR_PRESS_EN | PWR_TEMP_EN | MODE_NORMAL);
+    Sim_BMP388_Reset_Stats();
+    Async_Measure(&task[0], &sensor[0], NULL, NULL);
+    Async_Submit(&exec, &task[0]);
+    Async_Run(&exec);
+    Sim_BMP388_Get_Stats(&sim);
+    Check(task[0].status == ASYNC_DONE, "medida en modo normal");
+    Check(Sim_BMP388_Peek(REG_PWR_CNTRL) == (PWR_PRESS_EN | PWR_TEMP_EN | MODE_NORMAL), "modo normal conservado");
+    Check(sim.conversions == 0, "sin conversiones forzadas en modo normal");
+    Transport_Write(REG_PWR_CNTRL, PWR_PRESS_EN | PWR_TEMP_EN | MODE_SLEEP);
+
+    // Medida y descarga del mismo sensor: la descarga espera a que acabe la medida
+    Sim_BMP388_Fill_Fifo(TEST_FIFO_FRAMES);
+    bus_log_len = 0;
+    Async_Measure(&task[0], &sensor[0], NULL, NULL);
+    Async_Drain_FIFO(&task[1], &sensor[0], raw[0], samples[0], TEST_FIFO_FRAMES, NULL, NULL);
+    Async_Submit(&exec, &task[0]);
+    Async_Submit(&exec, &task[1]);
+    Async_Run(&exec);
+    Check(task[0].status == ASYNC_DONE && task[1].status == ASYNC_DONE, "medida y descarga terminadas");
+    Check(task[1].count == TEST_FIFO_FRAMES, "muestras de la FIFO");
+    bool fifo_seen = false;
+    bool interleaved = false;
+    for (uint8_t i = 0; i < bus_log_len; i++)
+    {
+        bool fifo = bus_log[i] == REG_FIFO_LENGTH || bus_log[i] == REG_FIFO_DATA;
+        interleaved |= fifo_seen && !fifo;
+        fifo_seen |= fifo;
+    }
+    Check(fifo_seen && !interleaved, "medida y descarga sin intercalar");
+
+    // Corrutinas: una por sensor en el mismo ejecutor
+    struct AsyncTask co_measure[2];
+    struct AsyncTask co_drain[2];
+    AsyncSensorCo co_sensor[2] = {AsyncSensorCo(&exec, &sensor[0]), AsyncSensorCo(&exec, &sensor[1])};
+    for (uint8_t s = 0; s < 2; s++)
+    {
+        Sim_BMP388_Select(s);
+        Sim_BMP388_Fill_Fifo(TEST_FIFO_FRAMES);
+        co_measure[s].status = ASYNC_IDLE;
+        co_drain[s].status = ASYNC_IDLE;
+        Measure_Then_Drain(&co_sensor[s], raw[s], samples[s], &co_measure[s], &co_drain[s]);
+    }
+    Sim_BMP388_Select(0);
+    Async_Run(&exec);
+    for (uint8_t s = 0; s < 2; s++)
+    {
+        Check(co_measure[s].status == ASYNC_DONE, "co_await measure()");
+        Check(co_drain[s].status == ASYNC_DONE && co_drain[s].count == TEST_FIFO_FRAMES, "co_await drain_fifo()");
+    }
+    Check(co_measure[1].press == Expected_Press(&sensor[1], TEST_RAW_PRESS_ALT, SIM_BMP388_RAW_TEMP),
+          "presión del sensor 1 con corrutinas");
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
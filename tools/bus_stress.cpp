@@ -0,0 +1,230 @@
+/*
+ * Prueba de carga del gestor del bus en el host.
+ *
+ * Varias tareas se disputan un bus simulado que detecta solapes: lecturas de alta
+ * prioridad cortas y descargas de FIFO de baja prioridad troceadas con
+ * Bus_Hold_Chunk(), más una tarea que intenta alargar una ocupación de baja prioridad
+ * con tomas anidadas. Comprueba que nunca hay dos transacciones a la vez, que las de
+ * alta prioridad no agotan el plazo y esperan como mucho un trozo de baja, que las
+ * tomas anidadas se rechazan al superar BUS_HOLD_LIMIT_US y que las métricas cuadran
+ * con lo observado. Termina con código distinto de cero si algo falla.
+ *
+ * Compilación: g++ -O2 -pthread -Ihost -I.. bus_stress.cpp host/host.cpp ../bus.cpp -o bus_stress
+ */
+#include "bus.h"
+#include "stdio.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define STRESS_HIGH_TASKS     2
+#define STRESS_LOW_TASKS      2
+#define STRESS_HIGH_READS     400
+#define STRESS_LOW_DRAINS     60
+#define STRESS_FIFO_BYTES     516
+#define STRESS_CLOCK_HZ       400000
+#define STRESS_READ_US        150  // Lectura de registros: ~6 bytes a 400 kHz
+#define STRESS_WAIT_SLACK_US  1500 // Margen por el planificador del host
+
+static std::atomic<int> bus_users(0);
+static std::atomic<uint32_t> overlaps(0);
+static std::atomic<uint32_t> locks_ok(0);
+static std::atomic<uint32_t> high_timeouts(0);
+static std::atomic<uint32_t> refused(0);
+
+/**
+ * @brief Transacción simulada: ocupa el bus el tiempo indicado y detecta solapes. Como
+ * el periférico del ESP32, deja la CPU libre mientras dura.
+ */
+static void Sim_Transaction(uint32_t us)
+{
+    if (bus_users.fetch_add(1) != 0)
+    {
+        overlaps++;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+    bus_users.fetch_sub(1);
+}
+
+static uint32_t Chunk_Us(uint16_t bytes)
+{
+    return (uint32_t)((uint64_t)(bytes + 3) * 9 * 1000000 / STRESS_CLOCK_HZ);
+}
+
+static void High_Task(std::vector<uint32_t> *waits)
+{
+    for (int i = 0; i < STRESS_HIGH_READS; i++)
+    {
+        uint32_t start = micros();
+        if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+        {
+            high_timeouts++;
+            continue;
+        }
+        waits->push_back(micros() - start);
+        locks_ok++;
+        Sim_Transaction(STRESS_READ_US);
+        Bus_Unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(500 + (i % 7) * 200));
+    }
+}
+
+static void Low_Task()
+{
+    uint16_t chunk = Bus_Hold_Chunk(STRESS_CLOCK_HZ, 9, 3, 128);
+
+    for (int i = 0; i < STRESS_LOW_DRAINS; i++)
+    {
+        for (uint16_t done = 0; done < STRESS_FIFO_BYTES; done += chunk)
+        {
+            uint16_t bytes = std::min<uint16_t>(chunk, STRESS_FIFO_BYTES - done);
+            if (Bus_Lock(BUS_PRIO_LOW, 100) != BUS_LOCK_SUCCESS)
+            {
+                continue;
+            }
+            locks_ok++;
+            Sim_Transaction(Chunk_Us(bytes));
+            Bus_Unlock();
+        }
+    }
+}
+
+/**
+ * @brief Descarga que intenta quedarse el bus entre trozos con tomas anidadas
+ */
+static void Greedy_Task()
+{
+    uint16_t chunk = Bus_Hold_Chunk(STRESS_CLOCK_HZ, 9, 3, 128);
+
+    for (int i = 0; i < STRESS_LOW_DRAINS; i++)
+    {
+        if (Bus_Lock(BUS_PRIO_LOW, 100) != BUS_LOCK_SUCCESS)
+        {
+            continue;
+        }
+        locks_ok++;
+        for (uint16_t done = 0; done < STRESS_FIFO_BYTES; done += chunk)
+        {
+            if (Bus_Lock(BUS_PRIO_LOW, 100) != BUS_LOCK_SUCCESS)
+            {
+                // Rechazada: se suelta el bus y se sigue con una toma nueva
+                refused++;
+                Bus_Unlock();
+                while (Bus_Lock(BUS_PRIO_LOW, 100) != BUS_LOCK_SUCCESS)
+                {
+                }
+                locks_ok++;
+                Sim_Transaction(Chunk_Us(std::min<uint16_t>(chunk, STRESS_FIFO_BYTES - done)));
+                continue;
+            }
+            Sim_Transaction(Chunk_Us(std::min<uint16_t>(chunk, STRESS_FIFO_BYTES - done)));
+            Bus_Unlock();
+        }
+        Bus_Unlock();
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    if (Init_Bus() != BUS_LOCK_SUCCESS)
+    {
+        printf("FALLO: Init_Bus\n");
+        return 1;
+    }
+
+    // Reentrancia desde la misma tarea
+    if (Bus_Lock(BUS_PRIO_HIGH, 1) != BUS_LOCK_SUCCESS || Bus_Lock(BUS_PRIO_LOW, 1) != BUS_LOCK_SUCCESS)
+    {
+        printf("FALLO: toma anidada\n");
+        failures++;
+    }
+    Bus_Unlock();
+    Bus_Unlock();
+    // Un plazo enorme no debe desbordar a cero
+    if (Bus_Lock(BUS_PRIO_HIGH, UINT32_MAX) != BUS_LOCK_SUCCESS)
+    {
+        printf("FALLO: plazo de UINT32_MAX ms\n");
+        failures++;
+    }
+    Bus_Unlock();
+    Reset_Bus_Stats();
+
+    std::vector<std::vector<uint32_t>> waits(STRESS_HIGH_TASKS);
+    std::vector<std::thread> tasks;
+    std::atomic<bool> done(false);
+    std::thread reader([&done] {
+        // Lecturas y puestas a cero concurrentes de las métricas
+        struct BusStats stats;
+        while (!done)
+        {
+            Get_Bus_Stats(&stats);
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+    });
+
+    for (int i = 0; i < STRESS_HIGH_TASKS; i++)
+    {
+        tasks.emplace_back(High_Task, &waits[i]);
+    }
+    for (int i = 0; i < STRESS_LOW_TASKS; i++)
+    {
+        tasks.emplace_back(Low_Task);
+    }
+    tasks.emplace_back(Greedy_Task);
+    for (auto &task : tasks)
+    {
+        task.join();
+    }
+    done = true;
+    reader.join();
+
+    std::vector<uint32_t> all;
+    for (auto &w : waits)
+    {
+        all.insert(all.end(), w.begin(), w.end());
+    }
+    std::sort(all.begin(), all.end());
+    uint32_t p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+    uint32_t bound = Chunk_Us(Bus_Hold_Chunk(STRESS_CLOCK_HZ, 9, 3, 128)) + STRESS_READ_US + STRESS_WAIT_SLACK_US;
+
+    struct BusStats stats;
+    Get_Bus_Stats(&stats);
+    printf("trozo de baja prioridad: %u bytes (%u us)\n", Bus_Hold_Chunk(STRESS_CLOCK_HZ, 9, 3, 128),
+           Chunk_Us(Bus_Hold_Chunk(STRESS_CLOCK_HZ, 9, 3, 128)));
+    printf("tomas %u, disputadas %u, cesiones %u, rechazos anidados %u, plazos agotados %u\n", stats.acquisitions,
+           stats.contended, stats.yields, stats.preemptions, stats.timeouts);
+    printf("espera de alta prioridad: p99 %u us, máx %u us (cota %u us)\n", p99, all.empty() ? 0 : all.back(), bound);
+    printf("ocupación máx %u us, excesos %u\n", stats.max_hold_us, stats.hold_overruns);
+
+    if (overlaps != 0)
+    {
+        printf("FALLO: %u transacciones solapadas\n", overlaps.load());
+        failures++;
+    }
+    if (high_timeouts != 0)
+    {
+        printf("FALLO: %u lecturas de alta prioridad fuera de plazo\n", high_timeouts.load());
+        failures++;
+    }
+    if (p99 > bound)
+    {
+        printf("FALLO: p99 de la espera de alta prioridad por encima de la cota\n");
+        failures++;
+    }
+    if (stats.acquisitions != locks_ok)
+    {
+        printf("FALLO: métricas %u tomas, observadas %u\n", stats.acquisitions, locks_ok.load());
+        failures++;
+    }
+    if (stats.preemptions != refused)
+    {
+        printf("FALLO: métricas %u rechazos, observados %u\n", stats.preemptions, refused.load());
+        failures++;
+    }
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
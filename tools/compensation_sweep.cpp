@@ -0,0 +1,228 @@
+/*
+ * Caracterización de los modos de compensación en el host.
+ *
+ * Barre la temperatura de -40 a 85 ºC y todo el rango de la lectura de presión sin
+ * compensar (24 bits), se queda con los puntos dentro del rango del sensor
+ * (300-1250 hPa) y compara cada modo con la referencia en double: error máximo y
+ * RMS en Pa, y tiempo por muestra en ns. La tabla (COMP_LUT) se mide con una
+ * rejilla de SWEEP_LUT_TEMP x SWEEP_LUT_PRESS sobre el mismo rango.
+ *
+ * Compilación: g++ -O2 -I.. compensation_sweep.cpp ../compensation.cpp ../comp_lut.cpp -o compensation_sweep
+ * Uso:         compensation_sweep [t1 t2 t3 p1 p2 p3 p4 p5 p6 p7 p8 p9 p10 p11]
+ *              (sin argumentos se usa una calibración típica)
+ */
+#include "compensation.h"
+#include "comp_lut.h"
+#include "stdlib.h"
+#include "math.h"
+#include <chrono>
+#include <vector>
+
+#define SWEEP_TEMP_MIN   -40
+#define SWEEP_TEMP_MAX   85
+#define SWEEP_PRESS_MIN  30000.0
+#define SWEEP_PRESS_MAX  125000.0
+#define SWEEP_RAW_STEPS  4096
+#define SWEEP_ROUNDS     20
+#define SWEEP_LUT_TEMP   32
+#define SWEEP_LUT_PRESS  64
+
+struct SweepPoint
+{
+    uint32_t uncomp_temp;
+    uint32_t uncomp_press;
+    double temp;
+    double press;
+};
+
+struct SweepResult
+{
+    double max_error;
+    double sum_error2;
+    double ns_per_sample;
+};
+
+static struct RegCalibData reg;
+static struct DataCoefficients coeff;
+static struct DataCoefficientsDouble coeff_double;
+static struct CompLut lut;
+static float lut_table[SWEEP_LUT_TEMP * SWEEP_LUT_PRESS];
+
+/**
+ * @brief Lectura sin compensar que da una temperatura, por bisección sobre la referencia
+ */
+static uint32_t Find_Uncomp_Temp(double temp)
+{
+    uint32_t low = 0;
+    uint32_t high = 0xFFFFFF;
+
+    while (high - low > 1)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (Compensate_Temperature_Double(&coeff_double, mid) < temp)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return high;
+}
+
+static double Elapsed_ns(std::chrono::steady_clock::time_point start, size_t samples)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / samples;
+}
+
+static void Add_Error(struct SweepResult *result, double error)
+{
+    error = fabs(error);
+    result->sum_error2 += error * error;
+    if (error > result->max_error)
+    {
+        result->max_error = error;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long par[14] = {27772, 19004, -10, -1120, -2842, 32, 7, 19980, 24016, 3, -6, 14982, 6, -55};
+
+    if (argc == 15)
+    {
+        for (int i = 0; i < 14; i++)
+        {
+            par[i] = strtol(argv[i + 1], NULL, 0);
+        }
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, "uso: %s [t1 t2 t3 p1 p2 p3 p4 p5 p6 p7 p8 p9 p10 p11]\n", argv[0]);
+        return 1;
+    }
+
+    reg.nvm_par_t1 = par[0];
+    reg.nvm_par_t2 = par[1];
+    reg.nvm_par_t3 = par[2];
+    reg.nvm_par_p1 = par[3];
+    reg.nvm_par_p2 = par[4];
+    reg.nvm_par_p3 = par[5];
+    reg.nvm_par_p4 = par[6];
+    reg.nvm_par_p5 = par[7];
+    reg.nvm_par_p6 = par[8];
+    reg.nvm_par_p7 = par[9];
+    reg.nvm_par_p8 = par[10];
+    reg.nvm_par_p9 = par[11];
+    reg.nvm_par_p10 = par[12];
+    reg.nvm_par_p11 = par[13];
+    Calc_Coefficients(&reg, &coeff);
+    Calc_Coefficients_Double(&reg, &coeff_double);
+
+    // Puntos del barrido con su valor de referencia
+    std::vector<struct SweepPoint> points;
+    for (int t = SWEEP_TEMP_MIN; t <= SWEEP_TEMP_MAX; t++)
+    {
+        struct SweepPoint point;
+        point.uncomp_temp = Find_Uncomp_Temp(t);
+        point.temp = Compensate_Temperature_Double(&coeff_double, point.uncomp_temp);
+        for (uint32_t i = 0; i < SWEEP_RAW_STEPS; i++)
+        {
+            point.uncomp_press = (uint32_t)(((uint64_t)i * 0xFFFFFF) / (SWEEP_RAW_STEPS - 1));
+            point.press = Compensate_Pressure_Double(&coeff_double, point.uncomp_press, point.temp);
+            if (point.press >= SWEEP_PRESS_MIN && point.press <= SWEEP_PRESS_MAX)
+            {
+                points.push_back(point);
+            }
+        }
+    }
+    if (points.empty())
+    {
+        fprintf(stderr, "la calibración no da ningún punto en %.0f-%.0f Pa\n", SWEEP_PRESS_MIN, SWEEP_PRESS_MAX);
+        return 1;
+    }
+
+    struct CompLutConfig lut_config = {SWEEP_TEMP_MIN, SWEEP_TEMP_MAX, SWEEP_PRESS_MIN, SWEEP_PRESS_MAX,
+                                       SWEEP_LUT_TEMP, SWEEP_LUT_PRESS};
+    if (Init_Comp_LUT(&lut, &coeff, &lut_config, lut_table, SWEEP_LUT_TEMP * SWEEP_LUT_PRESS) != COMP_LUT_SUCCESS)
+    {
+        fprintf(stderr, "no se pudo preparar la tabla\n");
+        return 1;
+    }
+
+    struct SweepResult result[4] = {};
+    volatile double sink = 0;
+
+    // Error frente a la referencia
+    for (const struct SweepPoint &point : points)
+    {
+        float temp = Compensate_Temperature_Float(&coeff, point.uncomp_temp);
+        Add_Error(&result[COMP_FLOAT], Compensate_Pressure_Float(&coeff, point.uncomp_press, temp) - point.press);
+
+        int64_t t_lin = Compensate_Temperature_Fixed(&reg, point.uncomp_temp);
+        Add_Error(&result[COMP_FIXED], Compensate_Pressure_Fixed(&reg, point.uncomp_press, t_lin) / 100.0 - point.press);
+
+        Add_Error(&result[COMP_LUT], Comp_LUT_Pressure(&lut, point.uncomp_press, temp) - point.press);
+    }
+
+    // Coste por muestra: temperatura y presión, como en cada lectura del sensor
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < SWEEP_ROUNDS; round++)
+    {
+        for (const struct SweepPoint &point : points)
+        {
+            double temp = Compensate_Temperature_Double(&coeff_double, point.uncomp_temp);
+            sink = sink + Compensate_Pressure_Double(&coeff_double, point.uncomp_press, temp);
+        }
+    }
+    result[COMP_DOUBLE].ns_per_sample = Elapsed_ns(start, points.size() * SWEEP_ROUNDS);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < SWEEP_ROUNDS; round++)
+    {
+        for (const struct SweepPoint &point : points)
+        {
+            float temp = Compensate_Temperature_Float(&coeff, point.uncomp_temp);
+            sink = sink + Compensate_Pressure_Float(&coeff, point.uncomp_press, temp);
+        }
+    }
+    result[COMP_FLOAT].ns_per_sample = Elapsed_ns(start, points.size() * SWEEP_ROUNDS);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < SWEEP_ROUNDS; round++)
+    {
+        for (const struct SweepPoint &point : points)
+        {
+            int64_t t_lin = Compensate_Temperature_Fixed(&reg, point.uncomp_temp);
+            sink = sink + Compensate_Pressure_Fixed(&reg, point.uncomp_press, t_lin);
+        }
+    }
+    result[COMP_FIXED].ns_per_sample = Elapsed_ns(start, points.size() * SWEEP_ROUNDS);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < SWEEP_ROUNDS; round++)
+    {
+        for (const struct SweepPoint &point : points)
+        {
+            float temp = Compensate_Temperature_Float(&coeff, point.uncomp_temp);
+            sink = sink + Comp_LUT_Pressure(&lut, point.uncomp_press, temp);
+        }
+    }
+    result[COMP_LUT].ns_per_sample = Elapsed_ns(start, points.size() * SWEEP_ROUNDS);
+
+    const char *names[4] = {"double", "float", "fixed", "lut"};
+    printf("puntos: %zu (%d a %d ºC, %.0f-%.0f Pa)\n", points.size(), SWEEP_TEMP_MIN, SWEEP_TEMP_MAX,
+           SWEEP_PRESS_MIN, SWEEP_PRESS_MAX);
+    printf("modo,max_error_pa,rms_error_pa,ns_muestra,tiempo_frente_a_float\n");
+    for (int mode = COMP_DOUBLE; mode <= COMP_LUT; mode++)
+    {
+        printf("%s,%.4f,%.4f,%.1f,%.2f\n", names[mode], result[mode].max_error,
+               sqrt(result[mode].sum_error2 / points.size()), result[mode].ns_per_sample,
+               result[mode].ns_per_sample / result[COMP_FLOAT].ns_per_sample);
+    }
+    printf("tabla %dx%d (%d columnas usadas, paso 2^%d): %u bytes\n", SWEEP_LUT_TEMP, SWEEP_LUT_PRESS, lut.n_press,
+           lut.raw_shift, Comp_LUT_Memory(&lut));
+    return 0;
+}
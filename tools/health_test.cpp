@@ -0,0 +1,198 @@
+/*
+ * Prueba en el host de la recuperación del monitor de salud sobre el BMP388 simulado.
+ *
+ * Devuelve el sensor a sleep (como tras una caída de tensión) y hace fallar la primera
+ * escritura de la restauración: el intento debe quedar contado con el fallo abierto, y
+ * la siguiente comprobación debe pasar al reinicio completo y cerrarlo. Después
+ * comprueba que una presión leída desde otro hilo durante los reinicios sale siempre
+ * igual, también mientras se alternan dos tablas de compensación, que un reinicio
+ * devuelve la configuración de la aplicación y que leer a 4 veces el ODR no da datos
+ * congelados, mientras que conversiones idénticas sí. Termina con código distinto de
+ * cero si algo falla.
+ *
+ * Compilación: g++ -O2 -pthread -Ihost -I.. health_test.cpp host/host.cpp host/wire.cpp host/spi.cpp host/sim_bmp388.cpp
+ *              ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp ../transport.cpp ../sensor.cpp ../compensation.cpp
+ *              ../comp_lut.cpp ../health.cpp -o health_test
+ */
+#include "health.h"
+#include "sensor.h"
+#include "i2c.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+#include <atomic>
+#include <thread>
+
+#define TEST_INTERVAL_MS    1
+#define TEST_DIAG_WRITES    3  // Escrituras de dirección de registro en la lectura de diagnóstico
+#define TEST_REINITS        20
+#define TEST_LUT_SWAPS      20
+#define TEST_LUT_TEMP       16
+#define TEST_LUT_PRESS      64
+#define TEST_STUCK_SAMPLES  4
+#define TEST_READS_PER_ODR  4  // Lecturas por conversión
+#define TEST_CONVERSIONS    8
+#define TEST_STUCK_INTERVAL 60000 // Sin comprobaciones de registros durante la prueba
+
+static struct CompLut luts[2];
+static float lut_tables[2][TEST_LUT_TEMP * TEST_LUT_PRESS];
+
+static std::atomic<bool> reading(false);
+static std::atomic<uint32_t> mismatches(0);
+static std::atomic<uint32_t> compensations(0);
+static int failures = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Lecturas en ráfaga desde REG_STATUS de cada conversión, como la adquisición del pipeline
+ *
+ * @param monitor : contexto
+ * @param same : conversiones idénticas (dato congelado) o distintas
+ */
+static void Sample_Conversions(struct HealthMonitor *monitor, bool same)
+{
+    uint8_t data[7];
+
+    for (uint32_t i = 0; i < TEST_CONVERSIONS; i++)
+    {
+        uint32_t offset = same ? 0 : i;
+        Sim_BMP388_Set_Raw(SIM_BMP388_RAW_PRESS + offset, SIM_BMP388_RAW_TEMP + offset);
+        for (uint8_t j = 0; j < TEST_READS_PER_ODR; j++)
+        {
+            if (Transport_Read(REG_STATUS, data, 7) == TRANSPORT_SUCCESS)
+            {
+                uint32_t press = ((uint32_t)data[3] << 16) | ((uint32_t)data[2] << 8) | data[1];
+                uint32_t temp = ((uint32_t)data[6] << 16) | ((uint32_t)data[5] << 8) | data[4];
+                Health_Sample(monitor, press, temp, data[0]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tarea de proceso: compensa en bucle la lectura por defecto del simulador
+ */
+static void Compensate_Loop(float expected)
+{
+    while (reading)
+    {
+        float temp = Compensate_Temperature(SIM_BMP388_RAW_TEMP);
+        if (Compensate_Pressure(SIM_BMP388_RAW_PRESS, temp) != expected)
+        {
+            mismatches++;
+        }
+        compensations++;
+    }
+}
+
+int main()
+{
+    struct I2CRetryPolicy policy = {0, I2C_DEFAULT_BACKOFF_US, I2C_DEFAULT_DEADLINE_US, 0};
+    static struct HealthMonitor monitor;
+    struct HealthStats stats;
+
+    Sim_BMP388_Power_On();
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport");
+    Set_I2C_Retry_Policy(&policy);
+    // Modo normal y por_detected ya leído: el único fallo será el de modo
+    uint8_t pwr = PWR_PRESS_EN | PWR_TEMP_EN | MODE_NORMAL;
+    uint8_t event;
+    Transport_Write(REG_PWR_CNTRL, pwr);
+    Transport_Read8(REG_EVENT, &event);
+    Check(Init_Health_Monitor(&monitor, 0, TEST_INTERVAL_MS) == HEALTH_SUCCESS, "Init_Health_Monitor");
+
+    // Vuelta a sleep y primera escritura de la restauración fallida
+    Sim_BMP388_Poke(REG_PWR_CNTRL, pwr & (PWR_PRESS_EN | PWR_TEMP_EN));
+    Host_Wire_Inject_After(TEST_DIAG_WRITES, 3, 1);
+    delay(2 * TEST_INTERVAL_MS);
+    uint8_t faults = Health_Poll(&monitor);
+    Get_Health_Stats(&monitor, &stats);
+    Check(faults == HEALTH_FAULT_MODE, "fallo de modo abierto tras una restauración fallida");
+    Check(stats.targeted_reinits == 1 && stats.recoveries == 0, "intento contado sin recuperación");
+    Check(Sim_BMP388_Peek(REG_PWR_CNTRL) != pwr, "sensor aún en sleep");
+
+    // Siguiente comprobación: reinicio completo y restauración
+    delay(2 * TEST_INTERVAL_MS);
+    faults = Health_Poll(&monitor);
+    Get_Health_Stats(&monitor, &stats);
+    Check(faults == HEALTH_FAULT_NONE, "fallo cerrado tras el reinicio completo");
+    Check(stats.full_reinits == 1 && stats.recoveries == 1, "reinicio completo tras el intento fallido");
+    Check(Sim_BMP388_Peek(REG_PWR_CNTRL) == pwr, "modo restaurado");
+    printf("intentos: %u dirigidos, %u completos, %u recuperaciones\n", stats.targeted_reinits, stats.full_reinits,
+           stats.recoveries);
+
+    // Compensación en otro hilo mientras se recalibra
+    float expected = Compensate_Pressure(SIM_BMP388_RAW_PRESS, Compensate_Temperature(SIM_BMP388_RAW_TEMP));
+    reading = true;
+    std::thread processing(Compensate_Loop, expected);
+    uint8_t reinits = 0;
+    for (uint8_t i = 0; i < TEST_REINITS; i++)
+    {
+        reinits += Reinit_BMP() == REINIT_SENSOR_SUCCESS ? 1 : 0;
+    }
+    reading = false;
+    processing.join();
+    printf("%u reinicios, %u compensaciones concurrentes, %u distintas\n", reinits, compensations.load(),
+           mismatches.load());
+    Check(reinits == TEST_REINITS, "reinicios");
+    Check(mismatches == 0, "compensación estable durante los reinicios");
+
+    // Tablas alternadas con la compensación en marcha; la tabla en uso no se reescribe
+    struct CompLutConfig lut_config = {-40.0f, 85.0f, 30000.0f, 110000.0f, TEST_LUT_TEMP, TEST_LUT_PRESS};
+    uint32_t lut_len = TEST_LUT_TEMP * TEST_LUT_PRESS;
+    Check(Set_Compensation_LUT(&luts[0], &lut_config, lut_tables[0], lut_len) == COMP_LUT_SUCCESS,
+          "Set_Compensation_LUT");
+    expected = Compensate_Pressure(SIM_BMP388_RAW_PRESS, Compensate_Temperature(SIM_BMP388_RAW_TEMP));
+    mismatches = 0;
+    reading = true;
+    std::thread lut_processing(Compensate_Loop, expected);
+    uint8_t swaps = 0;
+    for (uint8_t i = 1; i <= TEST_LUT_SWAPS; i++)
+    {
+        uint8_t next = i % 2;
+        swaps += Set_Compensation_LUT(&luts[next], &lut_config, lut_tables[next], lut_len) == COMP_LUT_SUCCESS ? 1 : 0;
+    }
+    uint8_t live = TEST_LUT_SWAPS % 2;
+    Check(Set_Compensation_LUT(&luts[live], &lut_config, lut_tables[live], lut_len) == COMP_LUT_FAILED,
+          "tabla en uso rechazada");
+    reading = false;
+    lut_processing.join();
+    printf("%u cambios de tabla, %u distintas\n", swaps, mismatches.load());
+    Check(swaps == TEST_LUT_SWAPS, "cambios de tabla");
+    Check(mismatches == 0, "compensación estable durante los cambios de tabla");
+    Set_Compensation_Mode(COMP_FLOAT);
+
+    // Configuración de la aplicación restaurada tras el reinicio, en modo normal
+    Check(Set_Oversampling(OVRS_X8, OVRS_X2) == SET_OVERSAMPLING_SUCCESS, "Set_Oversampling");
+    Check(Set_IRR_Filter(COEFF_3) == SET_IRR_FILTER_SUCCESS, "Set_IRR_Filter");
+    Check(Set_Output_Data_Rate(ODR_25) == SET_ODR_SUCCESS, "Set_Output_Data_Rate");
+    uint8_t osr = Sim_BMP388_Peek(REG_OSR);
+    uint8_t odr = Sim_BMP388_Peek(REG_ODR);
+    uint8_t config = Sim_BMP388_Peek(REG_CONFIG);
+    Check(Reinit_BMP() == REINIT_SENSOR_SUCCESS, "reinicio con configuración");
+    Check(Sim_BMP388_Peek(REG_OSR) == osr && Sim_BMP388_Peek(REG_ODR) == odr &&
+              Sim_BMP388_Peek(REG_CONFIG) == config,
+          "oversampling, ODR y filtro restaurados");
+    Check(Sim_BMP388_Peek(REG_PWR_CNTRL) == pwr, "modo normal restaurado");
+
+    // Más lecturas que conversiones: sólo las conversiones nuevas cuentan como repetidas
+    static struct HealthMonitor stuck_monitor;
+    Check(Init_Health_Monitor(&stuck_monitor, TEST_STUCK_SAMPLES, TEST_STUCK_INTERVAL) == HEALTH_SUCCESS,
+          "Init_Health_Monitor con datos congelados");
+    Sample_Conversions(&stuck_monitor, false);
+    Get_Health_Stats(&stuck_monitor, &stats);
+    Check(stats.stuck == 0, "sin dato congelado leyendo a 4 veces el ODR");
+    Sample_Conversions(&stuck_monitor, true);
+    Get_Health_Stats(&stuck_monitor, &stats);
+    Check(stats.stuck == 1, "dato congelado con conversiones idénticas");
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * Sustituto mínimo del núcleo de Arduino para compilar el driver en el host.
+ *
+ * Los pines sólo guardan su nivel; attachInterrupt() registra la rutina y
+ * Host_Trigger_Interrupt() la ejecuta como si llegara el flanco.
+ */
+
+#include "stdint.h"
+#include "stddef.h"
+#include "stdbool.h"
+#include "string.h"
+#include "stdlib.h"
+#include "math.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+typedef enum
+{
+    GPIO_NUM_4 = 4,
+    GPIO_NUM_5 = 5,
+    GPIO_NUM_13 = 13,
+    GPIO_NUM_16 = 16,
+    GPIO_NUM_18 = 18,
+    GPIO_NUM_19 = 19,
+    GPIO_NUM_23 = 23
+} gpio_num_t;
+
+#define HOST_PINS           40
+
+#define LOW                 0
+#define HIGH                1
+#define INPUT               0x01
+#define OUTPUT              0x03
+#define INPUT_PULLUP        0x05
+#define OUTPUT_OPEN_DRAIN   0x13
+#define RISING              0x01
+#define FALLING             0x02
+
+unsigned long micros();
+unsigned long millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline int digitalPinToInterrupt(int pin)
+{
+    return pin;
+}
+void attachInterrupt(int irq, void (*isr)(), int mode);
+void detachInterrupt(int irq);
+
+/**
+ * @brief Ejecución de la rutina asociada a un pin, desde el hilo que llama
+ *
+ * @param pin : pin
+ * @return true si había rutina
+ */
+bool Host_Trigger_Interrupt(uint8_t pin);
+
+/**
+ * @brief Modo de flanco con que se registró la rutina del pin (0 si no hay)
+ */
+int Host_Interrupt_Mode(uint8_t pin);
+
+/**
+ * @brief Nivel que leerá digitalRead() en un pin de entrada
+ */
+void Host_Set_Pin(uint8_t pin, uint8_t value);
@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+ * Sustituto de SPIClass para el host, conectado al BMP388 simulado. Cada trama va de
+ * beginTransaction() a endTransaction(): el primer byte es la dirección, con el bit
+ * de lectura un byte de relleno y los datos. El tiempo de bus (8 bits por byte al
+ * reloj de la trama) se acumula en Host_SPI_Bus_Us() en lugar de dormirlo: a 10 MHz
+ * una trama dura menos que la resolución del planificador del host.
+ */
+
+#include "Arduino.h"
+
+#define MSBFIRST    1
+#define SPI_MODE0   0
+#define SPI_MODE3   3
+#define HSPI        2
+#define VSPI        3
+
+class SPISettings
+{
+public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bit_order = MSBFIRST, uint8_t data_mode = SPI_MODE0)
+        : clock(clock), bit_order(bit_order), data_mode(data_mode)
+    {
+    }
+    uint32_t clock;
+    uint8_t bit_order;
+    uint8_t data_mode;
+};
+
+class SPIClass
+{
+public:
+    SPIClass(uint8_t spi_bus);
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1);
+    void end();
+    void beginTransaction(SPISettings settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    void transferBytes(const uint8_t *data, uint8_t *out, uint32_t size);
+
+private:
+    uint32_t clock_hz;
+    uint32_t frame_bytes;
+    uint8_t reg;
+    bool read;
+};
+
+/**
+ * @brief Tramas completas hechas sobre el bus
+ */
+uint32_t Host_SPI_Transactions();
+
+/**
+ * @brief Tiempo de bus acumulado por las tramas (us)
+ */
+uint64_t Host_SPI_Bus_Us();
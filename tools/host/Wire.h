@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ * Sustituto de TwoWire para el host, conectado al BMP388 simulado en ADDR_I2C; otras
+ * direcciones no responden. Cada transacción duerme lo que tardaría en el bus real
+ * (9 bits por byte más dirección y STOP) al reloj configurado.
+ *
+ * Una transacción que no cabe en el timeout configurado termina con timeout al agotarlo,
+ * y begin() tarda HOST_WIRE_BEGIN_US, como la instalación del driver en el ESP32.
+ *
+ * Host_Wire_Inject() fuerza códigos de error de endTransmission() para probar los
+ * reintentos: con el código 5 (timeout) la transacción tarda el timeout configurado,
+ * como con SCL retenida.
+ */
+
+#include "Arduino.h"
+
+#define HOST_WIRE_BUFFER    128
+#define HOST_WIRE_BEGIN_US  300
+
+class TwoWire
+{
+public:
+    TwoWire(uint8_t bus_num);
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock();
+    void setTimeOut(uint16_t timeout_ms);
+    uint16_t getTimeOut();
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool send_stop = true);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t len);
+    uint8_t requestFrom(uint8_t address, uint8_t len, bool send_stop = true);
+    int available();
+    int read();
+
+private:
+    uint32_t clock_hz;
+    uint16_t timeout_ms;
+    uint8_t address;
+    uint8_t reg;
+    uint8_t tx[HOST_WIRE_BUFFER];
+    size_t tx_len;
+    uint8_t rx[HOST_WIRE_BUFFER];
+    size_t rx_len;
+    size_t rx_pos;
+};
+
+/**
+ * @brief Las siguientes count transacciones terminan con el código de error indicado
+ *
+ * @param code : código de endTransmission() (2 NACK dirección, 3 NACK dato, 4 bus, 5 timeout)
+ * @param count : transacciones afectadas
+ */
+void Host_Wire_Inject(uint8_t code, uint32_t count);
+
+/**
+ * @brief Como Host_Wire_Inject(), pero tras dejar pasar skip endTransmission() correctos
+ *
+ * @param skip : endTransmission() que salen bien antes de los errores
+ * @param code : código de endTransmission()
+ * @param count : transacciones afectadas
+ */
+void Host_Wire_Inject_After(uint32_t skip, uint8_t code, uint32_t count);
+
+/**
+ * @brief Transacciones (escrituras y lecturas) hechas sobre el bus
+ */
+uint32_t Host_Wire_Transactions();
+
+/**
+ * @brief Tiempo de bus acumulado por las transacciones (us)
+ */
+uint64_t Host_Wire_Bus_Us();
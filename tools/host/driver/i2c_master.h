@@ -0,0 +1,97 @@
+#pragma once
+
+/*
+ * Sustituto del driver i2c_master de ESP-IDF para el host, conectado al BMP388
+ * simulado: el sensor 0 en ADDR_I2C y el 1 en ADDR_I2C_ALT. Sólo declara lo que usa
+ * i2c_idf.cpp. Cada llamada es una transacción de hardware y duerme lo que tardaría
+ * en el bus real (9 bits por byte más direcciones y STOP) al reloj del dispositivo.
+ *
+ * Host_IDF_Inject() fuerza errores del driver para probar los reintentos: con
+ * ESP_ERR_TIMEOUT la transacción tarda el timeout que se le pasa, como con SCL retenida.
+ */
+
+#include "Arduino.h"
+
+typedef int esp_err_t;
+
+#define ESP_OK                      0
+#define ESP_FAIL                    -1
+#define ESP_ERR_NO_MEM              0x101
+#define ESP_ERR_INVALID_ARG         0x102
+#define ESP_ERR_INVALID_STATE       0x103
+#define ESP_ERR_NOT_FOUND           0x105
+#define ESP_ERR_TIMEOUT             0x107
+#define ESP_ERR_INVALID_RESPONSE    0x108
+
+typedef int i2c_port_num_t;
+
+typedef enum
+{
+    I2C_CLK_SRC_DEFAULT = 0
+} i2c_clock_source_t;
+
+typedef enum
+{
+    I2C_ADDR_BIT_LEN_7 = 0,
+    I2C_ADDR_BIT_LEN_10
+} i2c_addr_bit_len_t;
+
+typedef struct
+{
+    i2c_port_num_t i2c_port;
+    gpio_num_t sda_io_num;
+    gpio_num_t scl_io_num;
+    i2c_clock_source_t clk_source;
+    uint8_t glitch_ignore_cnt;
+    int intr_priority;
+    size_t trans_queue_depth;
+    struct
+    {
+        uint32_t enable_internal_pullup : 1;
+    } flags;
+} i2c_master_bus_config_t;
+
+typedef struct
+{
+    i2c_addr_bit_len_t dev_addr_length;
+    uint16_t device_address;
+    uint32_t scl_speed_hz;
+    uint32_t scl_wait_us;
+} i2c_device_config_t;
+
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle);
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle);
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus_handle, uint16_t address, int xfer_timeout_ms);
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms);
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size, int xfer_timeout_ms);
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus_handle);
+
+/**
+ * @brief Las siguientes count transacciones terminan con el error indicado
+ *
+ * @param err : ESP_ERR_TIMEOUT, ESP_ERR_INVALID_STATE (NACK) u otro error del driver
+ * @param count : transacciones afectadas
+ */
+void Host_IDF_Inject(esp_err_t err, uint32_t count);
+
+/**
+ * @brief Transacciones de hardware hechas sobre el bus (transmit, transmit_receive y probe)
+ */
+uint32_t Host_IDF_Transactions();
+
+/**
+ * @brief Recuperaciones del bus pedidas al driver
+ */
+uint32_t Host_IDF_Resets();
+
+/**
+ * @brief Mayor lectura hecha en una sola transacción (bytes)
+ */
+uint32_t Host_IDF_Max_Read();
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * Sustituto de FreeRTOS para las herramientas del host: tareas sobre hilos POSIX,
+ * un tick por milisegundo y secciones críticas con un único cerrojo global.
+ */
+
+#include "stdint.h"
+#include "stddef.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t; // Como en ESP-IDF: la pila se mide en bytes
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portMAX_DELAY           0xFFFFFFFF
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define configMAX_PRIORITIES    25
+
+#define IRAM_ATTR
+
+typedef struct
+{
+    int unused;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void Host_Enter_Critical();
+void Host_Exit_Critical();
+
+#define portENTER_CRITICAL(mux)     Host_Enter_Critical()
+#define portEXIT_CRITICAL(mux)      Host_Exit_Critical()
+#define portENTER_CRITICAL_ISR(mux) Host_Enter_Critical()
+#define portEXIT_CRITICAL_ISR(mux)  Host_Exit_Critical()
+
+// Memoria de los objetos estáticos: el host construye encima sus propios objetos
+typedef struct
+{
+    alignas(16) unsigned char storage[256];
+} StaticTask_t;
+
+typedef struct
+{
+    alignas(16) unsigned char storage[256];
+} StaticSemaphore_t;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct HostMutex *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t mutex);
+
+/**
+ * @brief Hace fallar las siguientes creaciones de mutex, para probar los errores de inicialización
+ *
+ * @param fail : true mientras deban fallar
+ */
+void Host_Fail_Mutex_Create(bool fail);
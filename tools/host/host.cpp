@@ -0,0 +1,372 @@
+/*
+ * Implementación en el host del sustituto de Arduino y FreeRTOS (ver Arduino.h y
+ * freertos/FreeRTOS.h). Las tareas son hilos; los objetos estáticos (TCB y
+ * semáforos) se construyen sobre el búfer que aporta el driver, así que crearlos
+ * tampoco reserva memoria aparte de la del propio hilo.
+ */
+#include "Arduino.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+struct HostTask
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+    TaskFunction_t code = NULL;
+    void *arg = NULL;
+};
+
+struct HostMutex
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    TaskHandle_t holder = NULL;
+    uint32_t depth = 0;
+};
+
+static_assert(sizeof(HostTask) <= sizeof(StaticTask_t), "StaticTask_t pequeño para HostTask");
+static_assert(sizeof(HostMutex) <= sizeof(StaticSemaphore_t), "StaticSemaphore_t pequeño para HostMutex");
+
+// Fin de una tarea que se borra a sí misma
+struct HostTaskExit
+{
+};
+
+static std::recursive_mutex critical;
+static std::atomic<bool> fail_mutex_create(false);
+static thread_local HostTask thread_task;
+static thread_local HostTask *current_task = NULL;
+
+static std::mutex pin_lock;
+static uint8_t pin_level[HOST_PINS];
+static void (*pin_isr[HOST_PINS])();
+static int pin_isr_mode[HOST_PINS];
+
+static std::chrono::steady_clock::time_point Start_Time()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+static void Task_Trampoline(HostTask *task)
+{
+    current_task = task;
+    try
+    {
+        task->code(task->arg);
+    }
+    catch (const HostTaskExit &)
+    {
+    }
+}
+
+static std::chrono::steady_clock::time_point Deadline(TickType_t ticks)
+{
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks);
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+unsigned long micros()
+{
+    return (unsigned long)(uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - Start_Time())
+        .count();
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - Start_Time())
+        .count();
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    // Como en el ESP32, espera activa: el planificador del host no resuelve microsegundos
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    std::lock_guard<std::mutex> guard(pin_lock);
+    if (pin < HOST_PINS)
+    {
+        pin_level[pin] = value;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    std::lock_guard<std::mutex> guard(pin_lock);
+    return pin < HOST_PINS ? pin_level[pin] : LOW;
+}
+
+void Host_Set_Pin(uint8_t pin, uint8_t value)
+{
+    digitalWrite(pin, value);
+}
+
+void attachInterrupt(int irq, void (*isr)(), int mode)
+{
+    std::lock_guard<std::mutex> guard(pin_lock);
+    if (irq >= 0 && irq < HOST_PINS)
+    {
+        pin_isr[irq] = isr;
+        pin_isr_mode[irq] = mode;
+    }
+}
+
+void detachInterrupt(int irq)
+{
+    std::lock_guard<std::mutex> guard(pin_lock);
+    if (irq >= 0 && irq < HOST_PINS)
+    {
+        pin_isr[irq] = NULL;
+        pin_isr_mode[irq] = 0;
+    }
+}
+
+bool Host_Trigger_Interrupt(uint8_t pin)
+{
+    void (*isr)() = NULL;
+    {
+        std::lock_guard<std::mutex> guard(pin_lock);
+        if (pin < HOST_PINS)
+        {
+            isr = pin_isr[pin];
+        }
+    }
+    if (isr == NULL)
+    {
+        return false;
+    }
+    isr();
+    return true;
+}
+
+int Host_Interrupt_Mode(uint8_t pin)
+{
+    std::lock_guard<std::mutex> guard(pin_lock);
+    return pin < HOST_PINS ? pin_isr_mode[pin] : 0;
+}
+
+void Host_Enter_Critical()
+{
+    critical.lock();
+}
+
+void Host_Exit_Critical()
+{
+    critical.unlock();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    if (current_task == NULL)
+    {
+        current_task = &thread_task;
+    }
+    return current_task;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char *name, uint32_t stack, void *arg,
+                                           UBaseType_t prio, StackType_t *stack_buffer, StaticTask_t *tcb,
+                                           BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+    (void)prio;
+    (void)stack_buffer;
+    (void)core;
+
+    HostTask *task = new (tcb->storage) HostTask();
+    task->code = code;
+    task->arg = arg;
+    std::thread(Task_Trampoline, task).detach();
+    return task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    // Sólo para código antiguo: el TCB queda reservado hasta el final del proceso
+    StaticTask_t *tcb = new StaticTask_t;
+    TaskHandle_t task = xTaskCreateStaticPinnedToCore(code, name, stack, arg, prio, NULL, tcb, core);
+    if (handle != NULL)
+    {
+        *handle = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    // Un hilo no se puede matar desde fuera: sólo se admite que la tarea se borre a sí misma
+    if (task == NULL || task == xTaskGetCurrentTaskHandle())
+    {
+        throw HostTaskExit();
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelayUntil(TickType_t *last_wake, TickType_t period)
+{
+    *last_wake += period;
+    int32_t remaining = (int32_t)(*last_wake - xTaskGetTickCount());
+    if (remaining > 0)
+    {
+        vTaskDelay(remaining);
+    }
+    else
+    {
+        *last_wake = xTaskGetTickCount();
+    }
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)millis();
+}
+
+void taskYIELD()
+{
+    std::this_thread::yield();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    HostTask *task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+
+    if (ticks == portMAX_DELAY)
+    {
+        task->cv.wait(guard, [task] { return task->notify > 0; });
+    }
+    else
+    {
+        task->cv.wait_until(guard, Deadline(ticks), [task] { return task->notify > 0; });
+    }
+
+    uint32_t value = task->notify;
+    if (value > 0)
+    {
+        task->notify = clear ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notify++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    xTaskNotifyGive(task);
+    if (woken != NULL)
+    {
+        *woken = pdTRUE;
+    }
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer)
+{
+    if (fail_mutex_create)
+    {
+        return NULL;
+    }
+    return new (buffer->storage) HostMutex();
+}
+
+void Host_Fail_Mutex_Create(bool fail)
+{
+    fail_mutex_create = fail;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(mutex->lock);
+
+    if (mutex->holder == self)
+    {
+        mutex->depth++;
+        return pdTRUE;
+    }
+
+    bool free = true;
+    if (ticks == portMAX_DELAY)
+    {
+        mutex->cv.wait(guard, [mutex] { return mutex->holder == NULL; });
+    }
+    else
+    {
+        free = mutex->cv.wait_until(guard, Deadline(ticks), [mutex] { return mutex->holder == NULL; });
+    }
+    if (!free)
+    {
+        return pdFALSE;
+    }
+    mutex->holder = self;
+    mutex->depth = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    std::unique_lock<std::mutex> guard(mutex->lock);
+
+    if (mutex->holder != xTaskGetCurrentTaskHandle())
+    {
+        return pdFALSE;
+    }
+    if (--mutex->depth == 0)
+    {
+        mutex->holder = NULL;
+        guard.unlock();
+        mutex->cv.notify_all();
+    }
+    return pdTRUE;
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t mutex)
+{
+    std::lock_guard<std::mutex> guard(mutex->lock);
+    return mutex->holder;
+}
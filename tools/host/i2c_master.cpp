@@ -0,0 +1,237 @@
+/*
+ * Sustituto del driver i2c_master de ESP-IDF sobre el BMP388 simulado (ver driver/i2c_master.h).
+ */
+#include "driver/i2c_master.h"
+#include "def.h"
+#include "sim_bmp388.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+struct i2c_master_bus_t
+{
+    i2c_port_num_t port;
+};
+
+struct i2c_master_dev_t
+{
+    uint16_t address;
+    uint32_t clock_hz;
+    bool added;
+};
+
+static struct i2c_master_bus_t host_bus;
+static struct i2c_master_dev_t host_devs[SIM_BMP388_DEVICES]; // Un dispositivo por sensor simulado
+static bool bus_created = false;
+
+static std::atomic<uint32_t> inject_count(0);
+static std::atomic<esp_err_t> inject_err(ESP_OK);
+static std::atomic<uint32_t> transactions(0);
+static std::atomic<uint32_t> resets(0);
+static std::atomic<uint32_t> max_read(0);
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Duración en el bus a 9 bits por byte
+ */
+static void Bus_Time(uint32_t clock_hz, size_t bytes)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)bytes * 9 * 1000000 / clock_hz));
+}
+
+/**
+ * @brief Sensor simulado en una dirección i2c
+ *
+ * @return int índice del sensor o -1 si nadie responde
+ */
+static int Device(uint16_t addr)
+{
+    return addr == ADDR_I2C ? 0 : addr == ADDR_I2C_ALT ? 1 : -1;
+}
+
+/**
+ * @brief Dispositivo registrado en el bus
+ */
+static bool Is_Added(i2c_master_dev_handle_t handle)
+{
+    for (uint8_t i = 0; i < SIM_BMP388_DEVICES; i++)
+    {
+        if (handle == &host_devs[i])
+        {
+            return handle->added;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Cuenta la transacción y consume un error inyectado si lo hay
+ *
+ * @return esp_err_t ESP_OK si la transacción sigue adelante
+ */
+static esp_err_t Begin_Transaction(int xfer_timeout_ms)
+{
+    transactions++;
+
+    uint32_t pending = inject_count.load();
+    while (pending > 0 && !inject_count.compare_exchange_weak(pending, pending - 1))
+    {
+    }
+    if (pending == 0)
+    {
+        return ESP_OK;
+    }
+
+    esp_err_t err = inject_err.load();
+    if (err == ESP_ERR_TIMEOUT && xfer_timeout_ms > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(xfer_timeout_ms));
+    }
+    return err;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    if (bus_created)
+    {
+        return ESP_ERR_INVALID_STATE; // Puerto ya en uso, como en el driver real
+    }
+    host_bus.port = bus_config->i2c_port;
+    bus_created = true;
+    *ret_bus_handle = &host_bus;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle)
+{
+    if (bus_handle != &host_bus || dev_config->scl_speed_hz == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint8_t i = 0; i < SIM_BMP388_DEVICES; i++)
+    {
+        if (!host_devs[i].added)
+        {
+            host_devs[i].address = dev_config->device_address;
+            host_devs[i].clock_hz = dev_config->scl_speed_hz;
+            host_devs[i].added = true;
+            *ret_handle = &host_devs[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    if (!Is_Added(handle))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    handle->added = false;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus_handle, uint16_t address, int xfer_timeout_ms)
+{
+    if (bus_handle != &host_bus)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = Begin_Transaction(xfer_timeout_ms);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return Device(address) >= 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms)
+{
+    if (!Is_Added(i2c_dev) || write_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = Begin_Transaction(xfer_timeout_ms);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    Bus_Time(i2c_dev->clock_hz, write_size + 2);
+    int dev = Device(i2c_dev->address);
+    if (dev < 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (size_t i = 1; i < write_size; i++)
+    {
+        Sim_BMP388_Write(dev, write_buffer[0] + i - 1, write_buffer[i]);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size, int xfer_timeout_ms)
+{
+    if (!Is_Added(i2c_dev) || write_size != 1 || read_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = Begin_Transaction(xfer_timeout_ms);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Dirección de escritura, registro, START repetido, dirección de lectura, datos y STOP
+    Bus_Time(i2c_dev->clock_hz, write_size + read_size + 3);
+    int dev = Device(i2c_dev->address);
+    if (dev < 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    Sim_BMP388_Read(dev, write_buffer[0], read_buffer, read_size);
+
+    uint32_t seen = max_read.load();
+    while (read_size > seen && !max_read.compare_exchange_weak(seen, (uint32_t)read_size))
+    {
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus_handle)
+{
+    if (bus_handle != &host_bus)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    resets++;
+    return ESP_OK;
+}
+
+void Host_IDF_Inject(esp_err_t err, uint32_t count)
+{
+    inject_err = err;
+    inject_count = count;
+}
+
+uint32_t Host_IDF_Transactions()
+{
+    return transactions;
+}
+
+uint32_t Host_IDF_Resets()
+{
+    return resets;
+}
+
+uint32_t Host_IDF_Max_Read()
+{
+    return max_read;
+}
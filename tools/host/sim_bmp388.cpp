@@ -0,0 +1,305 @@
+/*
+ * BMP388 simulado (ver sim_bmp388.h).
+ */
+#include "sim_bmp388.h"
+#include "def.h"
+#include "fifo.h"
+#include "string.h"
+#include <chrono>
+#include <mutex>
+
+#define SIM_REGS            0x80
+#define SIM_STATUS_CMD_RDY  0x10
+#define SIM_PWR_MODE_MASK   0x30
+#define SIM_FRAME_BYTES     7
+
+// Calibración típica, la misma que usa compensation_sweep
+static const uint8_t calib[] = {
+    0x7C, 0x6C,             // par_t1 = 27772
+    0x3C, 0x4A,             // par_t2 = 19004
+    0xF6,                   // par_t3 = -10
+    0xA0, 0xFB,             // par_p1 = -1120
+    0xE6, 0xF4,             // par_p2 = -2842
+    0x20,                   // par_p3 = 32
+    0x07,                   // par_p4 = 7
+    0x0C, 0x4E,             // par_p5 = 19980
+    0xD0, 0x5D,             // par_p6 = 24016
+    0x03,                   // par_p7 = 3
+    0xFA,                   // par_p8 = -6
+    0x86, 0x3A,             // par_p9 = 14982
+    0x06,                   // par_p10 = 6
+    0xC9                    // par_p11 = -55
+};
+
+/*! Estado de un sensor */
+struct SimDevice
+{
+    uint8_t regs[SIM_REGS];
+    uint8_t fifo[SIM_BMP388_FIFO_BYTES];
+    uint16_t fifo_len;
+    uint16_t fifo_pos;
+    uint32_t raw_press;
+    uint32_t raw_temp;
+    struct SimBmp388Stats stats;
+};
+
+static std::mutex sim_lock;
+static struct SimDevice devices[SIM_BMP388_DEVICES];
+static uint8_t selected = 0;
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+static struct SimDevice *Device(uint8_t dev)
+{
+    return &devices[dev < SIM_BMP388_DEVICES ? dev : 0];
+}
+
+static void Put24(struct SimDevice *sim, uint8_t reg, uint32_t value)
+{
+    sim->regs[reg] = value & 0xFF;
+    sim->regs[reg + 1] = (value >> 8) & 0xFF;
+    sim->regs[reg + 2] = (value >> 16) & 0xFF;
+}
+
+/**
+ * @brief Conversión: registros de datos con la lectura actual y dato disponible
+ */
+static void Convert(struct SimDevice *sim)
+{
+    Put24(sim, REG_PRESS, sim->raw_press);
+    Put24(sim, REG_TEMP, sim->raw_temp);
+    sim->regs[REG_STATUS] |= (1 << STATUS_DRDY_PRESS) | (1 << STATUS_DRDY_TEMP);
+    sim->regs[REG_INT_STATUS] |= (1 << INT_STATUS_DRDY);
+}
+
+/**
+ * @brief Registros por defecto tras alimentación o reinicio por software
+ */
+static void Defaults(struct SimDevice *sim)
+{
+    memset(sim->regs, 0, sizeof(sim->regs));
+    sim->regs[REG_CHIP_ID] = CHIP_ID;
+    sim->regs[REG_STATUS] = SIM_STATUS_CMD_RDY;
+    sim->regs[REG_EVENT] = 1 << EVENT_POR_DETECTED;
+    sim->regs[REG_FIFO_WTM] = 0x01;
+    sim->regs[REG_FIFO_CONFIG_1] = 0x02;
+    sim->regs[REG_FIFO_CONFIG_2] = 0x02;
+    sim->regs[REG_INT_CTRL] = 0x02;
+    sim->regs[REG_OSR] = 0x02;
+    Put24(sim, REG_PRESS, 0x800000);
+    Put24(sim, REG_TEMP, 0x800000);
+    memcpy(&sim->regs[NVM_PAR_T1], calib, sizeof(calib));
+    sim->fifo_len = 0;
+    sim->fifo_pos = 0;
+}
+
+static uint16_t Fifo_Pending(const struct SimDevice *sim)
+{
+    return sim->fifo_len - sim->fifo_pos;
+}
+
+/**
+ * @brief Valor de un registro en el momento de leerlo
+ */
+static uint8_t Reg_Value(const struct SimDevice *sim, uint8_t reg)
+{
+    switch (reg)
+    {
+    case REG_SENSORTIME:
+    case REG_SENSORTIME + 1:
+    case REG_SENSORTIME + 2:
+    {
+        // Reloj interno de 24 bits a 25,6 kHz
+        uint32_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count() *
+                         10 / 390;
+        return (ticks >> (8 * (reg - REG_SENSORTIME))) & 0xFF;
+    }
+    case REG_FIFO_LENGTH:
+        return Fifo_Pending(sim) & 0xFF;
+    case REG_FIFO_LENGTH + 1:
+        return (Fifo_Pending(sim) >> 8) & 0x01;
+    default:
+        return reg < SIM_REGS ? sim->regs[reg] : 0;
+    }
+}
+
+/**
+ * @brief Efectos de leer un registro
+ */
+static void Read_Effects(struct SimDevice *sim, uint8_t reg)
+{
+    switch (reg)
+    {
+    case REG_ERR:
+    case REG_EVENT:
+    case REG_INT_STATUS:
+        sim->regs[reg] = 0;
+        break;
+    case REG_PRESS + 2:
+        sim->regs[REG_STATUS] &= ~(1 << STATUS_DRDY_PRESS);
+        break;
+    case REG_TEMP + 2:
+        sim->regs[REG_STATUS] &= ~(1 << STATUS_DRDY_TEMP);
+        break;
+    default:
+        break;
+    }
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+void Sim_BMP388_Select(uint8_t dev)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    selected = dev < SIM_BMP388_DEVICES ? dev : 0;
+}
+
+void Sim_BMP388_Power_On()
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    struct SimDevice *sim = Device(selected);
+    Defaults(sim);
+    sim->raw_press = SIM_BMP388_RAW_PRESS;
+    sim->raw_temp = SIM_BMP388_RAW_TEMP;
+}
+
+void Sim_BMP388_Set_Raw(uint32_t uncomp_press, uint32_t uncomp_temp)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    struct SimDevice *sim = Device(selected);
+    sim->raw_press = uncomp_press & 0xFFFFFF;
+    sim->raw_temp = uncomp_temp & 0xFFFFFF;
+    if ((sim->regs[REG_PWR_CNTRL] & SIM_PWR_MODE_MASK) == MODE_NORMAL)
+    {
+        Convert(sim);
+    }
+}
+
+void Sim_BMP388_Read(uint8_t dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    struct SimDevice *sim = Device(dev);
+    sim->stats.reads++;
+    sim->stats.bytes_read += len;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (reg == REG_FIFO_DATA)
+        {
+            // Sin datos el sensor devuelve tramas vacías
+            data[i] = Fifo_Pending(sim) > 0 ? sim->fifo[sim->fifo_pos++] : FIFO_FRAME_EMPTY;
+            continue;
+        }
+        data[i] = Reg_Value(sim, reg);
+        Read_Effects(sim, reg);
+        reg++;
+    }
+}
+
+void Sim_BMP388_Write(uint8_t dev, uint8_t reg, uint8_t value)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    struct SimDevice *sim = Device(dev);
+    sim->stats.writes++;
+
+    if (reg == REG_CMD)
+    {
+        if (value == CMD_SOFT_RESET)
+        {
+            sim->stats.soft_resets++;
+            Defaults(sim);
+        }
+        else if (value == CMD_FIFO_FLUSH)
+        {
+            sim->fifo_len = 0;
+            sim->fifo_pos = 0;
+        }
+        return;
+    }
+    if (reg >= SIM_REGS || reg < REG_FIFO_WTM)
+    {
+        // Registros de sólo lectura
+        return;
+    }
+
+    sim->regs[reg] = value;
+    if (reg == REG_PWR_CNTRL)
+    {
+        uint8_t mode = value & SIM_PWR_MODE_MASK;
+        if (mode == MODE_NORMAL)
+        {
+            Convert(sim);
+        }
+        else if (mode != MODE_SLEEP)
+        {
+            // Modo forzado: una conversión y vuelta a sleep
+            sim->stats.conversions++;
+            Convert(sim);
+            sim->regs[REG_PWR_CNTRL] &= ~SIM_PWR_MODE_MASK;
+        }
+    }
+}
+
+uint8_t Sim_BMP388_Peek(uint8_t reg)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    return Reg_Value(Device(selected), reg);
+}
+
+void Sim_BMP388_Poke(uint8_t reg, uint8_t value)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    if (reg < SIM_REGS)
+    {
+        Device(selected)->regs[reg] = value;
+    }
+}
+
+uint16_t Sim_BMP388_Fill_Fifo(uint16_t frames)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    struct SimDevice *sim = Device(selected);
+
+    // Se compacta lo ya leído antes de añadir
+    memmove(sim->fifo, sim->fifo + sim->fifo_pos, Fifo_Pending(sim));
+    sim->fifo_len = Fifo_Pending(sim);
+    sim->fifo_pos = 0;
+
+    for (uint16_t i = 0; i < frames && sim->fifo_len + SIM_FRAME_BYTES <= SIM_BMP388_FIFO_BYTES; i++)
+    {
+        uint8_t *frame = sim->fifo + sim->fifo_len;
+        frame[0] = FIFO_FRAME_PRESS_TEMP;
+        frame[1] = sim->raw_temp & 0xFF;
+        frame[2] = (sim->raw_temp >> 8) & 0xFF;
+        frame[3] = (sim->raw_temp >> 16) & 0xFF;
+        frame[4] = sim->raw_press & 0xFF;
+        frame[5] = (sim->raw_press >> 8) & 0xFF;
+        frame[6] = (sim->raw_press >> 16) & 0xFF;
+        sim->fifo_len += SIM_FRAME_BYTES;
+    }
+
+    uint16_t wtm = sim->regs[REG_FIFO_WTM] | ((sim->regs[REG_FIFO_WTM + 1] & 0x01) << 8);
+    if (wtm > 0 && sim->fifo_len >= wtm)
+    {
+        sim->regs[REG_INT_STATUS] |= 1 << INT_STATUS_FWTM;
+    }
+    if (sim->fifo_len + SIM_FRAME_BYTES > SIM_BMP388_FIFO_BYTES)
+    {
+        sim->regs[REG_INT_STATUS] |= 1 << INT_STATUS_FFULL;
+    }
+    return sim->fifo_len;
+}
+
+void Sim_BMP388_Get_Stats(struct SimBmp388Stats *stats)
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    *stats = Device(selected)->stats;
+}
+
+void Sim_BMP388_Reset_Stats()
+{
+    std::lock_guard<std::mutex> guard(sim_lock);
+    memset(&Device(selected)->stats, 0, sizeof(struct SimBmp388Stats));
+}
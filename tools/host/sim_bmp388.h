@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * BMP388 simulado para las pruebas en el host. Lo comparten los sustitutos de Wire,
+ * SPI y del driver i2c_master de ESP-IDF, así que el driver se prueba con cualquiera
+ * de sus backends sobre el mismo mapa de registros.
+ *
+ * Reproduce lo que el driver usa: identificación, calibración típica, modos (el
+ * forzado hace una conversión y vuelve a sleep), reinicio por software, registros de
+ * diagnóstico que se borran al leerlos y FIFO con tramas de temperatura y presión.
+ * La dirección avanza en las ráfagas salvo en REG_FIFO_DATA. Es seguro usarlo desde
+ * varios hilos.
+ *
+ * Hay SIM_BMP388_DEVICES sensores: Wire atiende el 0 en ADDR_I2C y el 1 en
+ * ADDR_I2C_ALT, y SPI el 0. Las funciones de la prueba actúan sobre el elegido con
+ * Sim_BMP388_Select(), el 0 por defecto.
+ */
+
+#include "stdint.h"
+#include "stddef.h"
+
+// Lectura en bruto por defecto: unos 25 ºC y 559 hPa con la calibración típica
+#define SIM_BMP388_RAW_TEMP     8519680
+#define SIM_BMP388_RAW_PRESS    6553600
+#define SIM_BMP388_FIFO_BYTES   512
+#define SIM_BMP388_DEVICES      2
+
+/*! Actividad vista por el sensor */
+struct SimBmp388Stats
+{
+    uint32_t reads;        // Transacciones de lectura
+    uint32_t writes;       // Escrituras de registro
+    uint32_t bytes_read;
+    uint32_t soft_resets;
+    uint32_t conversions;  // Conversiones en modo forzado
+};
+
+/**
+ * @brief Sensor sobre el que actúan las funciones de la prueba
+ *
+ * @param dev : índice del sensor
+ */
+void Sim_BMP388_Select(uint8_t dev);
+
+/*!
+ * @brief Estado tras la alimentación: registros por defecto, FIFO vacía y por_detected
+ */
+void Sim_BMP388_Power_On();
+
+/**
+ * @brief Lectura en bruto que darán las siguientes conversiones
+ *
+ * @param uncomp_press : presión sin compensar (24 bits)
+ * @param uncomp_temp : temperatura sin compensar (24 bits)
+ */
+void Sim_BMP388_Set_Raw(uint32_t uncomp_press, uint32_t uncomp_temp);
+
+/**
+ * @brief Lectura en ráfaga desde reg del sensor dev, con los efectos de leer cada registro
+ */
+void Sim_BMP388_Read(uint8_t dev, uint8_t reg, uint8_t *data, size_t len);
+
+/**
+ * @brief Escritura de un registro del sensor dev, con sus efectos (modo, comandos)
+ */
+void Sim_BMP388_Write(uint8_t dev, uint8_t reg, uint8_t value);
+
+/**
+ * @brief Valor de un registro sin efectos de lectura, para comprobar el estado
+ */
+uint8_t Sim_BMP388_Peek(uint8_t reg);
+
+/**
+ * @brief Cambio de un registro sin efectos, para simular fallos (p. ej. vuelta a sleep)
+ */
+void Sim_BMP388_Poke(uint8_t reg, uint8_t value);
+
+/**
+ * @brief Añade tramas de temperatura y presión a la FIFO con la lectura actual
+ *
+ * @param frames : tramas a añadir; las que no caben se pierden
+ * @return uint16_t bytes en la FIFO
+ */
+uint16_t Sim_BMP388_Fill_Fifo(uint16_t frames);
+
+/**
+ * @brief Copia de la actividad vista por el sensor
+ */
+void Sim_BMP388_Get_Stats(struct SimBmp388Stats *stats);
+
+/*!
+ * @brief Puesta a cero de la actividad
+ */
+void Sim_BMP388_Reset_Stats();
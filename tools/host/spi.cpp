@@ -0,0 +1,95 @@
+/*
+ * Sustituto de SPIClass sobre el BMP388 simulado (ver SPI.h).
+ */
+#include "SPI.h"
+#include "def.h"
+#include "sim_bmp388.h"
+#include <atomic>
+
+#define HOST_SPI_READ_BIT   0x80
+
+static std::atomic<uint32_t> transactions(0);
+static std::atomic<uint64_t> bus_ns(0);
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+SPIClass::SPIClass(uint8_t spi_bus) : clock_hz(1000000), frame_bytes(0), reg(0), read(false)
+{
+    (void)spi_bus;
+}
+
+void SPIClass::begin(int8_t sck, int8_t miso, int8_t mosi, int8_t ss)
+{
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+    clock_hz = settings.clock;
+    frame_bytes = 0;
+}
+
+void SPIClass::endTransaction()
+{
+    transactions++;
+    bus_ns += (uint64_t)frame_bytes * 8 * 1000000000 / clock_hz;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    uint8_t out = 0;
+
+    if (frame_bytes == 0)
+    {
+        reg = data & ~HOST_SPI_READ_BIT;
+        read = (data & HOST_SPI_READ_BIT) != 0;
+    }
+    else if (read && frame_bytes >= 2)
+    {
+        Sim_BMP388_Read(0, reg, &out, 1);
+        reg += reg == REG_FIFO_DATA ? 0 : 1;
+    }
+    else if (!read)
+    {
+        Sim_BMP388_Write(0, reg++, data);
+    }
+    frame_bytes++;
+    return out;
+}
+
+void SPIClass::transferBytes(const uint8_t *data, uint8_t *out, uint32_t size)
+{
+    if (read && frame_bytes >= 2 && out != NULL)
+    {
+        // Ráfaga de lectura: una sola transacción del sensor
+        Sim_BMP388_Read(0, reg, out, size);
+        reg += reg == REG_FIFO_DATA ? 0 : size;
+        frame_bytes += size;
+        return;
+    }
+    for (uint32_t i = 0; i < size; i++)
+    {
+        uint8_t rx = transfer(data != NULL ? data[i] : 0);
+        if (out != NULL)
+        {
+            out[i] = rx;
+        }
+    }
+}
+
+uint32_t Host_SPI_Transactions()
+{
+    return transactions;
+}
+
+uint64_t Host_SPI_Bus_Us()
+{
+    return bus_ns / 1000;
+}
@@ -0,0 +1,215 @@
+/*
+ * Sustituto de TwoWire sobre el BMP388 simulado (ver Wire.h).
+ */
+#include "Wire.h"
+#include "def.h"
+#include "sim_bmp388.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<uint32_t> inject_skip(0);
+static std::atomic<uint32_t> inject_count(0);
+static std::atomic<uint8_t> inject_code(0);
+static std::atomic<uint32_t> transactions(0);
+static std::atomic<uint64_t> bus_us(0);
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Duración en el bus: dirección, bytes y STOP a 9 bits por byte
+ *
+ * @return bool false si la transacción no cabe en el timeout y lo ha agotado
+ */
+static bool Bus_Time(uint32_t clock_hz, uint16_t timeout_ms, size_t bytes)
+{
+    uint64_t us = (uint64_t)(bytes + 2) * 9 * 1000000 / clock_hz;
+    if (us > (uint64_t)timeout_ms * 1000)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return false;
+    }
+    bus_us += us;
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+    return true;
+}
+
+/**
+ * @brief Sensor simulado en una dirección i2c
+ *
+ * @return int índice del sensor o -1 si nadie responde
+ */
+static int Device(uint8_t addr)
+{
+    return addr == ADDR_I2C ? 0 : addr == ADDR_I2C_ALT ? 1 : -1;
+}
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+TwoWire::TwoWire(uint8_t bus_num)
+    : clock_hz(100000), timeout_ms(50), address(0), reg(0), tx_len(0), rx_len(0), rx_pos(0)
+{
+    (void)bus_num;
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+    (void)sda;
+    (void)scl;
+    if (frequency > 0)
+    {
+        clock_hz = frequency;
+    }
+    // Como en arduino-esp32, begin() vuelve al timeout por defecto
+    timeout_ms = 50;
+    std::this_thread::sleep_for(std::chrono::microseconds(HOST_WIRE_BEGIN_US));
+    return true;
+}
+
+bool TwoWire::end()
+{
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency)
+{
+    clock_hz = frequency;
+    return true;
+}
+
+uint32_t TwoWire::getClock()
+{
+    return clock_hz;
+}
+
+void TwoWire::setTimeOut(uint16_t timeout)
+{
+    timeout_ms = timeout;
+}
+
+uint16_t TwoWire::getTimeOut()
+{
+    return timeout_ms;
+}
+
+void TwoWire::beginTransmission(uint8_t addr)
+{
+    address = addr;
+    tx_len = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (tx_len >= HOST_WIRE_BUFFER)
+    {
+        return 0;
+    }
+    tx[tx_len++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len)
+{
+    size_t written = 0;
+    while (written < len && write(data[written]) == 1)
+    {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool send_stop)
+{
+    (void)send_stop;
+    transactions++;
+
+    uint32_t skip = inject_skip.load();
+    while (skip > 0 && !inject_skip.compare_exchange_weak(skip, skip - 1))
+    {
+    }
+    uint32_t pending = skip > 0 ? 0 : inject_count.load();
+    while (pending > 0 && !inject_count.compare_exchange_weak(pending, pending - 1))
+    {
+    }
+    if (pending > 0)
+    {
+        uint8_t code = inject_code.load();
+        if (code == 5)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        }
+        return code;
+    }
+
+    if (!Bus_Time(clock_hz, timeout_ms, tx_len))
+    {
+        return 5;
+    }
+    int dev = Device(address);
+    if (dev < 0)
+    {
+        return 2;
+    }
+    if (tx_len > 0)
+    {
+        reg = tx[0];
+    }
+    for (size_t i = 1; i < tx_len; i++)
+    {
+        Sim_BMP388_Write(dev, reg + i - 1, tx[i]);
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len, bool send_stop)
+{
+    (void)send_stop;
+    transactions++;
+    rx_len = 0;
+    rx_pos = 0;
+
+    if (!Bus_Time(clock_hz, timeout_ms, len))
+    {
+        return 0;
+    }
+    int dev = Device(addr);
+    if (dev < 0 || len > HOST_WIRE_BUFFER)
+    {
+        return 0;
+    }
+    Sim_BMP388_Read(dev, reg, rx, len);
+    rx_len = len;
+    return len;
+}
+
+int TwoWire::available()
+{
+    return (int)(rx_len - rx_pos);
+}
+
+int TwoWire::read()
+{
+    return rx_pos < rx_len ? rx[rx_pos++] : -1;
+}
+
+void Host_Wire_Inject(uint8_t code, uint32_t count)
+{
+    Host_Wire_Inject_After(0, code, count);
+}
+
+void Host_Wire_Inject_After(uint32_t skip, uint8_t code, uint32_t count)
+{
+    inject_code = code;
+    inject_count = count;
+    inject_skip = skip;
+}
+
+uint32_t Host_Wire_Transactions()
+{
+    return transactions;
+}
+
+uint64_t Host_Wire_Bus_Us()
+{
+    return bus_us;
+}
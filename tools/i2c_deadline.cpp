@@ -0,0 +1,132 @@
+/*
+ * Prueba en el host de la política de reintentos del i2c sobre el BMP388 simulado.
+ *
+ * Comprueba que los reintentos recuperan errores pasajeros, que una transacción nunca
+ * supera el plazo de la política aunque la espera por el bus, los timeouts de Wire
+ * (SCL retenida) y la recuperación del bus se sumen, que el coste de la recuperación se
+ * mide con el end()/begin() de Wire incluido, que una lectura de presión fallida
+ * reinicia el sensor una sola vez y que una ráfaga de I2C_MAX_BURST bytes a 100 kHz,
+ * más larga que el plazo por defecto, cabe en su plazo. Termina con código distinto de
+ * cero si algo falla.
+ *
+ * Compilación: g++ -O2 -pthread -Ihost -I.. i2c_deadline.cpp host/host.cpp host/wire.cpp host/spi.cpp host/sim_bmp388.cpp
+ *              ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp ../transport.cpp ../sensor.cpp ../compensation.cpp
+ *              ../comp_lut.cpp -o i2c_deadline
+ */
+#include "i2c.h"
+#include "sensor.h"
+#include "transport.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+#include <thread>
+
+#define DEADLINE_SLACK_US   1500 // Margen por el planificador del host
+
+static int failures = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Lectura de un registro y su duración
+ */
+static I2CEnum_t Timed_Read(uint32_t *elapsed_us)
+{
+    uint8_t value;
+    uint32_t start = micros();
+    I2CEnum_t rslt = Read8_bit(REG_CHIP_ID, ADDR_I2C, &value);
+    *elapsed_us = micros() - start;
+    return rslt;
+}
+
+/**
+ * @brief Otra tarea ocupa el bus durante hold_us
+ */
+static void Hold_Bus(uint32_t hold_us)
+{
+    Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS);
+    std::this_thread::sleep_for(std::chrono::microseconds(hold_us));
+    Bus_Unlock();
+}
+
+int main()
+{
+    struct I2CStats before;
+    struct I2CStats after;
+    uint32_t elapsed;
+    uint32_t bound = I2C_DEFAULT_DEADLINE_US + DEADLINE_SLACK_US;
+
+    Sim_BMP388_Power_On();
+    Check(Init_I2C() == I2C_SUCCESS, "Init_I2C");
+
+    // Errores pasajeros: dos NACK y la tercera lectura sale bien
+    Get_I2C_Stats(&before);
+    Host_Wire_Inject(3, 2);
+    Check(Timed_Read(&elapsed) == I2C_READING_BYTES_SUCCESS, "lectura tras dos NACK");
+    Get_I2C_Stats(&after);
+    Check(after.retries - before.retries == 2, "dos reintentos");
+    printf("dos NACK: %u us\n", elapsed);
+
+    // SCL retenida: cada intento agota el timeout de Wire
+    Host_Wire_Inject(5, 100);
+    Check(Timed_Read(&elapsed) == I2C_TIMEOUT, "lectura con SCL retenida");
+    Check(elapsed <= bound, "plazo con SCL retenida");
+    printf("SCL retenida: %u us (cota %u us)\n", elapsed, bound);
+    Get_I2C_Stats(&after);
+    Check(after.recovery_us >= I2C_RECOVERY_US + HOST_WIRE_BEGIN_US, "coste de la recuperación medido");
+    printf("recuperación del bus: %u us medidos (%u us de pulsos)\n", after.recovery_us, I2C_RECOVERY_US);
+
+    // La espera por el bus consume parte del plazo
+    std::thread holder(Hold_Bus, I2C_DEFAULT_DEADLINE_US * 4 / 5);
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    Check(Timed_Read(&elapsed) == I2C_TIMEOUT, "lectura tras esperar el bus");
+    holder.join();
+    Check(elapsed <= bound, "plazo tras esperar el bus");
+    printf("bus ocupado y SCL retenida: %u us (cota %u us)\n", elapsed, bound);
+
+    // El bus no se libera dentro del plazo
+    holder = std::thread(Hold_Bus, I2C_DEFAULT_DEADLINE_US * 2);
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    Check(Timed_Read(&elapsed) == I2C_BUS_BUSY, "lectura con el bus ocupado");
+    holder.join();
+    Check(elapsed <= bound, "plazo con el bus ocupado");
+    printf("bus ocupado: %u us (cota %u us)\n", elapsed, bound);
+    Host_Wire_Inject(0, 0);
+
+    // Una lectura de presión con las dos lecturas fallidas reinicia el sensor una vez
+    struct I2CRetryPolicy policy = {0, I2C_DEFAULT_BACKOFF_US, I2C_DEFAULT_DEADLINE_US, 1};
+    struct SimBmp388Stats sim;
+    float press;
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport");
+    Set_I2C_Retry_Policy(&policy);
+    Sim_BMP388_Reset_Stats();
+    Host_Wire_Inject(2, 2);
+    Check(Get_Press(&press) == GET_PRESS_FAILED, "presión con el sensor sin responder");
+    Sim_BMP388_Get_Stats(&sim);
+    Check(sim.soft_resets == 1, "un solo reinicio por lectura fallida");
+    printf("reinicios por una lectura de presión fallida: %u\n", sim.soft_resets);
+    Check(Get_Press(&press) == GET_PRESS_SUCCESS, "presión tras el reinicio");
+
+    // Ráfaga máxima a 100 kHz: ~11.8 ms de bus frente a un plazo por defecto de 5 ms
+    struct I2CConfig slow = {SDA_I2C, SCL_I2C, I2C_CLOCK_100K, false};
+    struct I2CRetryPolicy defaults = {I2C_DEFAULT_RETRIES, I2C_DEFAULT_BACKOFF_US, I2C_DEFAULT_DEADLINE_US,
+                                      I2C_DEFAULT_REINIT_AFTER};
+    uint8_t burst[I2C_MAX_BURST];
+    Set_I2C_Config(&slow);
+    Check(Init_I2C() == I2C_SUCCESS, "Init_I2C a 100 kHz");
+    Set_I2C_Retry_Policy(&defaults);
+    uint32_t start = micros();
+    Check(I2C_Read_Bytes(NVM_PAR_T1, ADDR_I2C, burst, I2C_MAX_BURST) == I2C_READING_BYTES_SUCCESS,
+          "ráfaga de I2C_MAX_BURST bytes a 100 kHz");
+    elapsed = micros() - start;
+    printf("ráfaga de %u bytes a 100 kHz: %u us\n", I2C_MAX_BURST, elapsed);
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
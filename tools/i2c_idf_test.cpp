@@ -0,0 +1,151 @@
+/*
+ * Prueba en el host del backend i2c de ESP-IDF (i2c_idf.cpp) sobre el sustituto del
+ * driver i2c_master y el BMP388 simulado.
+ *
+ * Comprueba que la inicialización falla si no se crea el gestor del bus, el número de
+ * transacciones de hardware (una por lectura de registros, con Wire dos, y la FIFO en
+ * trozos de tramas completas dentro de BUS_HOLD_LIMIT_US), que un segundo sensor en
+ * ADDR_I2C_ALT se mide por async.h sin pasar por Wire, que los errores siguen la
+ * política de reintentos y su plazo y que los fallos seguidos reinician el sensor una
+ * sola vez. Termina con código distinto de cero si algo falla.
+ *
+ * Compilación: g++ -O2 -pthread -DUSE_I2C_IDF -Ihost -I.. i2c_idf_test.cpp host/host.cpp host/wire.cpp host/spi.cpp
+ *              host/i2c_master.cpp host/sim_bmp388.cpp ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp
+ *              ../transport.cpp ../sensor.cpp ../compensation.cpp ../comp_lut.cpp ../fifo.cpp ../async.cpp
+ *              -o i2c_idf_test
+ */
+#include "i2c_idf.h"
+#include "sensor.h"
+#include "fifo.h"
+#include "async.h"
+#include "driver/i2c_master.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+
+#define TEST_FIFO_FRAMES    70   // 490 bytes: varios trozos a 400 kHz
+#define DEADLINE_SLACK_US   1500 // Margen por el planificador del host
+#define TEST_RAW_PRESS_ALT  6000000 // Lectura del segundo sensor, distinta de la del primero
+
+static int failures = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+int main()
+{
+    struct I2CConfig config = {SDA_I2C, SCL_I2C, I2C_CLOCK_400K, false};
+    struct I2CIdfStats before;
+    struct I2CIdfStats after;
+    float press;
+    float press_wire;
+
+    Sim_BMP388_Power_On();
+    Set_I2C_IDF_Config(&config);
+
+    // Sin gestor del bus no se toca el driver
+    Host_Fail_Mutex_Create(true);
+    Check(Init_BMP_Transport(TRANSPORT_I2C_IDF) == INIT_SENSOR_FAILED, "Init_BMP_Transport sin gestor del bus");
+    Check(Host_IDF_Transactions() == 0, "sin transacciones si falla Init_Bus");
+    Host_Fail_Mutex_Create(false);
+
+    // Misma presión que con Wire y una transacción menos por lectura
+    Set_I2C_Config(&config);
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport con Wire");
+    uint32_t wire_trans = Host_Wire_Transactions();
+    Check(Get_Press(&press_wire) == GET_PRESS_SUCCESS, "presión con Wire");
+    wire_trans = Host_Wire_Transactions() - wire_trans;
+
+    struct SimBmp388Stats sim;
+    Check(Init_BMP_Transport(TRANSPORT_I2C_IDF) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport con ESP-IDF");
+    uint32_t trans = Host_IDF_Transactions();
+    Sim_BMP388_Reset_Stats();
+    Check(Get_Press(&press) == GET_PRESS_SUCCESS, "presión con ESP-IDF");
+    trans = Host_IDF_Transactions() - trans;
+    Sim_BMP388_Get_Stats(&sim);
+    printf("Get_Press: %u transacciones con ESP-IDF, %u con Wire (%u lecturas)\n", trans, wire_trans, sim.reads);
+    Check(press == press_wire, "misma presión que con Wire");
+    Check(trans == sim.reads + sim.writes, "una transacción por lectura o escritura");
+    Check(wire_trans - trans == sim.reads, "una transacción menos por lectura que con Wire");
+
+    trans = Host_IDF_Transactions();
+    uint8_t calib[I2C_SELF_TEST_BLOCK];
+    Check(Transport_Read(NVM_PAR_T1, calib, sizeof(calib)) == TRANSPORT_SUCCESS, "lectura de la calibración");
+    Check(Host_IDF_Transactions() - trans == 1, "calibración en una transacción");
+
+    // Segundo sensor en ADDR_I2C_ALT por el mismo backend, sin pasar por Wire
+    struct AsyncBus bus;
+    struct AsyncSensor sensor;
+    struct AsyncTask task;
+    struct AsyncExecutor exec;
+    Sim_BMP388_Select(1);
+    Sim_BMP388_Power_On();
+    Sim_BMP388_Set_Raw(TEST_RAW_PRESS_ALT, SIM_BMP388_RAW_TEMP);
+    Sim_BMP388_Select(0);
+    wire_trans = Host_Wire_Transactions();
+    trans = Host_IDF_Transactions();
+    Async_I2C_Bus(&bus, ADDR_I2C_ALT);
+    Check(Init_Async_Sensor(&sensor, &bus) == ASYNC_DONE, "Init_Async_Sensor en ADDR_I2C_ALT");
+    Init_Async_Executor(&exec);
+    Async_Measure(&task, &sensor, NULL, NULL);
+    Check(Async_Submit(&exec, &task) == ASYNC_PENDING, "Async_Submit");
+    Async_Run(&exec);
+    Check(task.status == ASYNC_DONE && task.press != press, "medida del segundo sensor");
+    Check(Host_Wire_Transactions() == wire_trans, "segundo sensor sin pasar por Wire");
+    Check(Host_IDF_Transactions() > trans, "segundo sensor por ESP-IDF");
+
+    // FIFO en trozos que no ocupan el bus más de BUS_HOLD_LIMIT_US
+    static uint8_t raw[FIFO_MAX_BYTES];
+    uint16_t chunk = Bus_Hold_Chunk(I2C_CLOCK_400K, 9, 3, UINT16_MAX);
+    chunk -= chunk % FIFO_FRAME_BYTES;
+    uint16_t len = TEST_FIFO_FRAMES * FIFO_FRAME_BYTES;
+    Flush_FIFO();
+    Sim_BMP388_Fill_Fifo(TEST_FIFO_FRAMES);
+    trans = Host_IDF_Transactions();
+    Check(Read_FIFO(raw, len) == FIFO_SUCCESS, "lectura de la FIFO");
+    trans = Host_IDF_Transactions() - trans;
+    printf("FIFO de %u bytes: %u transacciones de hasta %u bytes\n", len, trans, Host_IDF_Max_Read());
+    Check(trans == (uint32_t)(len + chunk - 1) / chunk, "FIFO troceada");
+    Check(Host_IDF_Max_Read() <= chunk, "ningún trozo supera BUS_HOLD_LIMIT_US");
+    Check(Host_IDF_Max_Read() % FIFO_FRAME_BYTES == 0, "trozos de tramas completas");
+
+    // Errores pasajeros: dos NACK y la tercera lectura sale bien
+    uint8_t value;
+    Get_I2C_IDF_Stats(&before);
+    Host_IDF_Inject(ESP_ERR_INVALID_STATE, 2);
+    Check(I2C_IDF_Read(REG_CHIP_ID, &value, 1, BUS_PRIO_HIGH) == I2C_READING_BYTES_SUCCESS, "lectura tras dos NACK");
+    Get_I2C_IDF_Stats(&after);
+    Check(after.retries - before.retries == 2 && after.nacks - before.nacks == 2, "dos reintentos");
+    Check(after.failures == before.failures, "sin fallo tras los reintentos");
+
+    // SCL retenida: cada intento agota el timeout del driver y el bus se recupera tras él
+    uint32_t bound = I2C_DEFAULT_DEADLINE_US + DEADLINE_SLACK_US;
+    uint32_t resets = Host_IDF_Resets();
+    Host_IDF_Inject(ESP_ERR_TIMEOUT, 100);
+    uint32_t start = micros();
+    Check(I2C_IDF_Read(REG_CHIP_ID, &value, 1, BUS_PRIO_HIGH) == I2C_TIMEOUT, "lectura con SCL retenida");
+    uint32_t elapsed = micros() - start;
+    Host_IDF_Inject(ESP_OK, 0);
+    printf("SCL retenida: %u us (cota %u us), %u recuperaciones\n", elapsed, bound, Host_IDF_Resets() - resets);
+    Check(elapsed <= bound, "plazo con SCL retenida");
+    Check(Host_IDF_Resets() > resets, "recuperación del bus tras timeout");
+
+    // Una lectura de presión con las dos lecturas fallidas reinicia el sensor una vez
+    struct I2CRetryPolicy policy = {0, I2C_DEFAULT_BACKOFF_US, I2C_DEFAULT_DEADLINE_US, 1};
+    Set_I2C_Retry_Policy(&policy);
+    Sim_BMP388_Reset_Stats();
+    Host_IDF_Inject(ESP_ERR_INVALID_STATE, 2);
+    Check(Get_Press(&press) == GET_PRESS_FAILED, "presión con el sensor sin responder");
+    Sim_BMP388_Get_Stats(&sim);
+    printf("reinicios por una lectura de presión fallida: %u\n", sim.soft_resets);
+    Check(sim.soft_resets == 1, "un solo reinicio por lectura fallida");
+    Check(Get_Press(&press) == GET_PRESS_SUCCESS, "presión tras el reinicio");
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
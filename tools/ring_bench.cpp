@@ -0,0 +1,254 @@
+/*
+ * Rendimiento y latencia del pipeline en el host con hilos pthread.
+ *
+ * Primero el anillo solo: un hilo productor y otro consumidor (en núcleos distintos si
+ * el host los tiene) pasan BENCH_RING_FRAMES tramas numeradas; se comprueba que llegan
+ * todas y en orden y se mide el rendimiento y la latencia de inserción a extracción
+ * (mediana, p99 y máxima). Con el anillo lleno el productor reintenta, así que su
+ * contador de pérdidas cuenta aquí las veces que se llenó.
+ *
+ * Después el pipeline completo (pipeline.cpp) sobre el BMP388 simulado, en ráfaga y por
+ * FIFO, con las etapas como hilos del sustituto de FreeRTOS: muestras por segundo,
+ * peor ciclo de adquisición, peor proceso por muestra y latencia media y máxima de
+ * la conversión a la salida. Por FIFO cada muestra de una descarga debe llevar su propio
+ * instante. Al final arranca y para el pipeline seguido BENCH_RESTARTS veces: cada
+ * parada debe esperar a que las dos etapas vuelvan a aparcarse. Termina con código
+ * distinto de cero si se pierden tramas.
+ *
+ * Compilación: g++ -O2 -pthread -Ihost -I.. ring_bench.cpp host/host.cpp host/wire.cpp host/spi.cpp host/sim_bmp388.cpp
+ *              ../bus.cpp ../i2c.cpp ../i2c_idf.cpp ../spi.cpp ../transport.cpp ../sensor.cpp ../compensation.cpp
+ *              ../comp_lut.cpp ../fifo.cpp ../ring.cpp ../pipeline.cpp ../aggregator.cpp ../events.cpp ../health.cpp
+ *              -o ring_bench
+ */
+#include "ring.h"
+#include "pipeline.h"
+#include "fifo.h"
+#include "sensor.h"
+#include "i2c.h"
+#include "sim_bmp388.h"
+#include "stdio.h"
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#define BENCH_RING_FRAMES       1000000
+#define BENCH_PIPELINE_MS       2000
+#define BENCH_PIPELINE_PERIOD   2  // ms
+#define BENCH_FIFO_FRAMES       2  // Tramas que añade el sensor simulado en cada periodo
+#define BENCH_RESTARTS          50
+
+static struct RawRing ring;
+static std::vector<int64_t> push_ns(BENCH_RING_FRAMES);
+static std::vector<int64_t> latency_ns(BENCH_RING_FRAMES);
+static uint32_t out_of_order = 0;
+static std::atomic<bool> feeding(false);
+static std::atomic<uint32_t> outputs(0);
+static std::atomic<uint32_t> same_stamp(0); // Muestras con el mismo instante que la anterior
+static uint32_t last_acq_us = 0;
+static int failures = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FALLO: %s\n", what);
+        failures++;
+    }
+}
+
+static int64_t Now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Hilo en un núcleo concreto si el host tiene más de uno
+ */
+static pthread_t Start_Thread(void *(*code)(void *), int cpu)
+{
+    pthread_t thread;
+    pthread_create(&thread, NULL, code, NULL);
+    if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread, sizeof(set), &set);
+    }
+    return thread;
+}
+
+/**
+ * @brief Productor: reintenta con el anillo lleno para no perder tramas
+ */
+static void *Producer(void *arg)
+{
+    struct RawFrame frame = {};
+    (void)arg;
+
+    for (uint32_t seq = 0; seq < BENCH_RING_FRAMES; seq++)
+    {
+        frame.uncomp_press = seq;
+        push_ns[seq] = Now_ns();
+        while (!Ring_Push(&ring, &frame))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *Consumer(void *arg)
+{
+    struct RawFrame frame;
+    uint32_t expected = 0;
+    (void)arg;
+
+    while (expected < BENCH_RING_FRAMES)
+    {
+        if (!Ring_Pop(&ring, &frame))
+        {
+            sched_yield();
+            continue;
+        }
+        int64_t now = Now_ns();
+        if (frame.uncomp_press != expected)
+        {
+            out_of_order++;
+        }
+        latency_ns[expected] = now - push_ns[frame.uncomp_press % BENCH_RING_FRAMES];
+        expected++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sensor simulado produciendo tramas en la FIFO a ritmo constante
+ */
+static void *Feeder(void *arg)
+{
+    (void)arg;
+    while (feeding)
+    {
+        Sim_BMP388_Fill_Fifo(BENCH_FIFO_FRAMES);
+        usleep(BENCH_PIPELINE_PERIOD * 1000);
+    }
+    return NULL;
+}
+
+static void Count_Output(const struct PipelineSample *sample, void *user)
+{
+    (void)user;
+    if (outputs > 0 && sample->acq_us == last_acq_us)
+    {
+        same_stamp++;
+    }
+    last_acq_us = sample->acq_us;
+    outputs++;
+}
+
+static void Bench_Ring()
+{
+    Init_Ring(&ring);
+    int64_t start = Now_ns();
+    pthread_t consumer = Start_Thread(Consumer, 1);
+    pthread_t producer = Start_Thread(Producer, 0);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    double seconds = (Now_ns() - start) / 1e9;
+
+    std::sort(latency_ns.begin(), latency_ns.end());
+    printf("anillo (%d tramas de %d): %.2f Mtramas/s, latencia mediana %lld ns, p99 %lld ns, máx %lld ns, "
+           "%u veces lleno\n",
+           BENCH_RING_FRAMES, RING_SIZE, BENCH_RING_FRAMES / seconds / 1e6,
+           (long long)latency_ns[BENCH_RING_FRAMES / 2], (long long)latency_ns[BENCH_RING_FRAMES * 99 / 100],
+           (long long)latency_ns[BENCH_RING_FRAMES - 1], ring.dropped);
+    Check(out_of_order == 0, "tramas del anillo fuera de orden");
+    Check(Ring_Count(&ring) == 0, "tramas pendientes en el anillo");
+}
+
+static void Bench_Pipeline(const char *name, PipelineSource_t source)
+{
+    struct PipelineConfig config = {};
+    struct PipelineStats stats;
+    pthread_t feeder = 0;
+
+    config.source = source;
+    config.period_ms = BENCH_PIPELINE_PERIOD;
+    config.acq_core = PIPELINE_ACQ_CORE;
+    config.proc_core = PIPELINE_PROC_CORE;
+    config.filter_alpha = 0.5f;
+    config.output = Count_Output;
+    outputs = 0;
+    same_stamp = 0;
+
+    if (source == PIPELINE_FIFO)
+    {
+        Flush_FIFO();
+        feeding = true;
+        feeder = Start_Thread(Feeder, 0);
+    }
+    Check(Start_Pipeline(&config) == PIPELINE_SUCCESS, "Start_Pipeline");
+    usleep(BENCH_PIPELINE_MS * 1000);
+    Stop_Pipeline();
+    if (source == PIPELINE_FIFO)
+    {
+        feeding = false;
+        pthread_join(feeder, NULL);
+    }
+
+    Get_Pipeline_Stats(&stats);
+    printf("%-8s %9u %9u %7u %7u %9u %9u %9llu %9u %9.0f\n", name, stats.acquired, stats.processed, stats.dropped,
+           stats.bus_errors, stats.max_acq_us, stats.max_proc_us,
+           (unsigned long long)(stats.processed > 0 ? stats.total_latency_us / stats.processed : 0),
+           stats.max_latency_us, stats.processed * 1000.0 / BENCH_PIPELINE_MS);
+    Check(stats.processed > 0 && stats.processed == outputs, "muestras entregadas a la salida");
+    Check(stats.dropped == 0 && stats.bus_errors == 0, "tramas perdidas en el pipeline");
+    if (source == PIPELINE_FIFO)
+    {
+        Check(same_stamp == 0, "muestras de una descarga de FIFO con el mismo instante");
+    }
+}
+
+static void Restart_Pipeline()
+{
+    struct PipelineConfig config = {};
+
+    config.source = PIPELINE_BURST;
+    config.period_ms = BENCH_PIPELINE_PERIOD;
+    config.acq_core = PIPELINE_ACQ_CORE;
+    config.proc_core = PIPELINE_PROC_CORE;
+    config.filter_alpha = 1.0f;
+    uint16_t started = 0;
+    for (uint16_t i = 0; i < BENCH_RESTARTS; i++)
+    {
+        started += Start_Pipeline(&config) == PIPELINE_SUCCESS ? 1 : 0;
+        Stop_Pipeline();
+    }
+    printf("%u arranques y paradas seguidos\n", started);
+    Check(started == BENCH_RESTARTS, "arranques tras una parada inmediata");
+}
+
+int main()
+{
+    struct I2CConfig i2c = {SDA_I2C, SCL_I2C, I2C_CLOCK_1M, false};
+
+    Bench_Ring();
+
+    Sim_BMP388_Power_On();
+    Set_I2C_Config(&i2c);
+    Check(Init_BMP_Transport(TRANSPORT_I2C) == INIT_SENSOR_SUCCESS, "Init_BMP_Transport");
+    printf("%-8s %9s %9s %7s %7s %9s %9s %9s %9s %9s\n", "pipeline", "adquir.", "proces.", "perd.", "err.",
+           "acq máx", "proc máx", "lat media", "lat máx", "mues/s");
+    Bench_Pipeline("ráfaga", PIPELINE_BURST);
+    Bench_Pipeline("FIFO", PIPELINE_FIFO);
+    Restart_Pipeline();
+
+    printf(failures == 0 ? "OK\n" : "%d FALLOS\n", failures);
+    return failures == 0 ? 0 : 1;
+}
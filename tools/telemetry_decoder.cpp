@@ -0,0 +1,99 @@
+/*
+ * Decodificador de telemetría en el host.
+ *
+ * Lee el flujo binario de la UART desde un fichero o desde stdin (tubería) y escribe
+ * una línea CSV por muestra: seq,sensor_time,press,temp. Al terminar muestra por
+ * stderr las tramas válidas, las perdidas según la secuencia y los errores de CRC.
+ *
+ * Compilación: g++ -O2 -I.. telemetry_decoder.cpp ../telemetry.cpp -o telemetry_decoder
+ * Uso:         telemetry_decoder [fichero]   (p. ej. cat /dev/ttyUSB0 | telemetry_decoder)
+ */
+#include "telemetry.h"
+#include "stdio.h"
+
+int main(int argc, char **argv)
+{
+    FILE *input = stdin;
+    if (argc > 1)
+    {
+        input = fopen(argv[1], "rb");
+        if (input == NULL)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    uint8_t buf[TELEMETRY_FRAME_SIZE];
+    uint16_t len = 0;
+    bool overflow = false;
+    bool has_seq = false;
+    uint16_t next_seq = 0;
+    uint32_t frames = 0;
+    uint32_t lost = 0;
+    uint32_t crc_errors = 0;
+    uint32_t bad_frames = 0;
+    struct TelemetryFrame frame;
+    int c;
+
+    printf("seq,sensor_time,press,temp\n");
+    while ((c = fgetc(input)) != EOF)
+    {
+        if (c != 0)
+        {
+            // Tramas más largas que el máximo se descartan hasta el siguiente delimitador
+            if (len < sizeof(buf))
+            {
+                buf[len++] = (uint8_t)c;
+            }
+            else
+            {
+                overflow = true;
+            }
+            continue;
+        }
+
+        if (len == 0)
+        {
+            continue;
+        }
+
+        TelemetryEnum_t rslt = overflow ? TELEMETRY_FAILED : Telemetry_Decode(buf, len, &frame);
+        len = 0;
+        overflow = false;
+
+        if (rslt == TELEMETRY_CRC_ERROR)
+        {
+            crc_errors++;
+            continue;
+        }
+        if (rslt != TELEMETRY_SUCCESS)
+        {
+            bad_frames++;
+            continue;
+        }
+
+        if (has_seq && frame.seq != next_seq)
+        {
+            lost += (uint16_t)(frame.seq - next_seq);
+        }
+        has_seq = true;
+        next_seq = frame.seq + 1;
+        frames++;
+
+        for (uint8_t i = 0; i < frame.count; i++)
+        {
+            printf("%u,%lu,%.2f,%.2f\n", frame.seq, (unsigned long)frame.samples[i].sensor_time,
+                   frame.samples[i].press, frame.samples[i].temp);
+        }
+    }
+
+    fprintf(stderr, "frames=%lu lost=%lu crc_errors=%lu bad_frames=%lu\n", (unsigned long)frames,
+            (unsigned long)lost, (unsigned long)crc_errors, (unsigned long)bad_frames);
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+    return 0;
+}
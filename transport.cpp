@@ -0,0 +1,349 @@
+#include "transport.h"
+#include "i2c.h"
+#include "spi.h"
+#include "i2c_idf.h"
+#include "fifo.h"
+
+/*************************************************** FUNCIONES PRIVADAS ***************************************************/
+
+/**
+ * @brief Trozo de descarga de la FIFO redondeado a tramas completas. Cada trozo es una
+ * ráfaga distinta sobre REG_FIFO_DATA y el BMP388 no garantiza continuar una trama
+ * empezada en la anterior.
+ *
+ * @param max_bytes : bytes que caben en BUS_HOLD_LIMIT_US
+ * @return uint16_t múltiplo de FIFO_FRAME_BYTES, al menos una trama
+ */
+static uint16_t Fifo_Chunk(uint16_t max_bytes)
+{
+    uint16_t bytes = max_bytes - max_bytes % FIFO_FRAME_BYTES;
+    return bytes > 0 ? bytes : FIFO_FRAME_BYTES;
+}
+
+/*************************************************** ADAPTADOR I2C ***************************************************/
+
+static TransportEnum_t I2C_Transport_Init()
+{
+    return Init_I2C() == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+static TransportEnum_t I2C_Transport_Read(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return Transport_I2C_Read(ADDR_I2C, reg_addr, data, len);
+}
+
+static TransportEnum_t I2C_Transport_Write(uint8_t reg_addr, uint8_t data)
+{
+    return Transport_I2C_Write(ADDR_I2C, reg_addr, data);
+}
+
+static TransportEnum_t I2C_Transport_Write_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value)
+{
+    return Write8_Flag(ADDR_I2C, reg_addr, pos, value) == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+/*************************************************** ADAPTADOR I2C ESP-IDF ***************************************************/
+
+static TransportEnum_t I2C_IDF_Transport_Init()
+{
+    return Init_I2C_IDF() == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+/**
+ * @brief Lectura por el backend de ESP-IDF de un sensor en la dirección indicada
+ */
+static TransportEnum_t IDF_Read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    // Sin límite de ráfaga: una sola transacción directa al buffer del llamador
+    if (reg_addr != REG_FIFO_DATA)
+    {
+        return I2C_IDF_Read_Addr(i2c_addr, reg_addr, data, len, BUS_PRIO_HIGH) == I2C_READING_BYTES_SUCCESS
+                   ? TRANSPORT_SUCCESS
+                   : TRANSPORT_FAILED;
+    }
+
+    // La FIFO, con baja prioridad y en trozos de BUS_HOLD_LIMIT_US como con Wire
+    uint16_t max_chunk = Fifo_Chunk(Bus_Hold_Chunk(Get_I2C_IDF_Clock(), 9, 3, UINT16_MAX));
+    while (len > 0)
+    {
+        uint16_t chunk = len > max_chunk ? max_chunk : len;
+        if (I2C_IDF_Read_Addr(i2c_addr, reg_addr, data, chunk, BUS_PRIO_LOW) != I2C_READING_BYTES_SUCCESS)
+        {
+            return TRANSPORT_FAILED;
+        }
+        data += chunk;
+        len -= chunk;
+    }
+    return TRANSPORT_SUCCESS;
+}
+
+static TransportEnum_t I2C_IDF_Transport_Read(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return IDF_Read(ADDR_I2C, reg_addr, data, len);
+}
+
+static TransportEnum_t I2C_IDF_Transport_Write(uint8_t reg_addr, uint8_t data)
+{
+    return I2C_IDF_Write(reg_addr, data) == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+static TransportEnum_t I2C_IDF_Transport_Write_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value)
+{
+    uint8_t value_byte;
+    TransportEnum_t rtrn = TRANSPORT_FAILED;
+
+    // Lectura-modificación-escritura atómica respecto a otras tareas
+    if (Bus_Lock(BUS_PRIO_HIGH, BUS_TIMEOUT_MS) != BUS_LOCK_SUCCESS)
+    {
+        return TRANSPORT_FAILED;
+    }
+    if (I2C_IDF_Read(reg_addr, &value_byte, 1, BUS_PRIO_HIGH) == I2C_READING_BYTES_SUCCESS &&
+        I2C_IDF_Write(reg_addr, Set_Binary(value_byte, value, pos)) == I2C_SUCCESS)
+    {
+        rtrn = TRANSPORT_SUCCESS;
+    }
+    Bus_Unlock();
+    return rtrn;
+}
+
+/*************************************************** ADAPTADOR SPI ***************************************************/
+
+static TransportEnum_t SPI_Transport_Init()
+{
+    return Init_SPI() == SPI_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+static TransportEnum_t SPI_Transport_Read(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    if (reg_addr != REG_FIFO_DATA)
+    {
+        return SPI_Read_Bytes(reg_addr, data, len) == SPI_READING_BYTES_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+    }
+
+    // La FIFO, con baja prioridad y en trozos de BUS_HOLD_LIMIT_US como en i2c; a 10 MHz
+    // cabe entera en uno
+    uint16_t max_chunk = Fifo_Chunk(Bus_Hold_Chunk(SPI_CLOCK_HZ, 8, 2, UINT16_MAX));
+    while (len > 0)
+    {
+        uint16_t chunk = len > max_chunk ? max_chunk : len;
+        if (SPI_Read_Bulk(reg_addr, data, chunk) != SPI_READING_BYTES_SUCCESS)
+        {
+            return TRANSPORT_FAILED;
+        }
+        data += chunk;
+        len -= chunk;
+    }
+    return TRANSPORT_SUCCESS;
+}
+
+static TransportEnum_t SPI_Transport_Write(uint8_t reg_addr, uint8_t data)
+{
+    return SPI_Write8_bit(reg_addr, data) == SPI_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+static TransportEnum_t SPI_Transport_Write_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value)
+{
+    return SPI_Write8_Flag(reg_addr, pos, value) == SPI_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
+
+static const struct Transport i2c_transport = {
+    I2C_Transport_Init,
+    I2C_Transport_Read,
+    I2C_Transport_Write,
+    I2C_Transport_Write_Flag};
+
+static const struct Transport spi_transport = {
+    SPI_Transport_Init,
+    SPI_Transport_Read,
+    SPI_Transport_Write,
+    SPI_Transport_Write_Flag};
+
+static const struct Transport i2c_idf_transport = {
+    I2C_IDF_Transport_Init,
+    I2C_IDF_Transport_Read,
+    I2C_IDF_Transport_Write,
+    I2C_IDF_Transport_Write_Flag};
+
+static const struct Transport *transport = &i2c_transport;
+static TransportType_t transport_type = TRANSPORT_I2C;
+
+/*************************************************** FUNCINES PÚBLICAS ***************************************************/
+
+/**
+ * @brief Selección e inicialización del bus
+ *
+ * @param type : i2c, spi o i2c de ESP-IDF
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Init_Transport(TransportType_t type)
+{
+    switch (type)
+    {
+    case TRANSPORT_SPI:
+        transport = &spi_transport;
+        break;
+    case TRANSPORT_I2C_IDF:
+        transport = &i2c_idf_transport;
+        break;
+    default:
+        transport = &i2c_transport;
+        break;
+    }
+    transport_type = type;
+    return transport->init();
+}
+
+/**
+ * @brief Bus seleccionado actualmente
+ *
+ * @return TransportType_t
+ */
+TransportType_t Get_Transport_Type()
+{
+    return transport_type;
+}
+
+/**
+ * @brief Lectura en ráfaga de registros consecutivos
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read(uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    return transport->read(reg_addr, data, len);
+}
+
+/**
+ * @brief Lectura de registros de 8 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read8(uint8_t reg_addr, uint8_t *data)
+{
+    return transport->read(reg_addr, data, 1);
+}
+
+/**
+ * @brief Lectura de registros de 16 bits (little endian)
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read16(uint8_t reg_addr, uint16_t *data)
+{
+    uint8_t bytes[2];
+    TransportEnum_t rtrn = transport->read(reg_addr, bytes, 2);
+
+    if (rtrn == TRANSPORT_SUCCESS)
+    {
+        *data = (bytes[1] << 8) | bytes[0];
+    }
+    return rtrn;
+}
+
+/**
+ * @brief Lectura de registros de 24 bits (little endian)
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read24(uint8_t reg_addr, uint32_t *data)
+{
+    uint8_t bytes[3];
+    TransportEnum_t rtrn = transport->read(reg_addr, bytes, 3);
+
+    if (rtrn == TRANSPORT_SUCCESS)
+    {
+        *data = ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[1] << 8) | bytes[0];
+    }
+    return rtrn;
+}
+
+/*!
+ * @brief Escritura en registros de 8 bits
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] data : dato que escribimos en el registro
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Write(uint8_t reg_addr, uint8_t data)
+{
+    return transport->write(reg_addr, data);
+}
+
+/*!
+ * @brief Escritura por bandera en registro
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] pos : posición a cambiar
+ * @param[in] value : valor del bit
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Write_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value)
+{
+    return transport->write_flag(reg_addr, pos, value);
+}
+
+/**
+ * @brief Lectura en ráfaga de un sensor i2c en otra dirección, con la misma división
+ * en trozos que el bus i2c seleccionado. Con TRANSPORT_I2C_IDF va por el backend de
+ * ESP-IDF; si no, por Wire (requiere Init_I2C)
+ *
+ * @param i2c_addr : dirección del sensor (ADDR_I2C o ADDR_I2C_ALT)
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_I2C_Read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+    // Ráfagas troceadas al tamaño del buffer de TwoWire. La FIFO se lee siempre desde
+    // REG_FIFO_DATA y con baja prioridad, en trozos que no ocupan el bus más de
+    // BUS_HOLD_LIMIT_US (y de tramas completas) para no retrasar las lecturas de registros.
+    if (Get_Transport_Type() == TRANSPORT_I2C_IDF)
+    {
+        return IDF_Read(i2c_addr, reg_addr, data, len);
+    }
+
+    bool fifo = (reg_addr == REG_FIFO_DATA);
+    uint16_t max_chunk = fifo ? Fifo_Chunk(Bus_Hold_Chunk(Get_I2C_Clock(), 9, 3, I2C_MAX_BURST)) : I2C_MAX_BURST;
+    while (len > 0)
+    {
+        uint8_t chunk = len > max_chunk ? max_chunk : len;
+        I2CEnum_t rslt = fifo ? I2C_Read_Bulk(reg_addr, i2c_addr, data, chunk) : I2C_Read_Bytes(reg_addr, i2c_addr, data, chunk);
+        if (rslt != I2C_READING_BYTES_SUCCESS)
+        {
+            return TRANSPORT_FAILED;
+        }
+        if (!fifo)
+        {
+            reg_addr += chunk;
+        }
+        data += chunk;
+        len -= chunk;
+    }
+    return TRANSPORT_SUCCESS;
+}
+
+/**
+ * @brief Escritura de un registro de un sensor i2c en otra dirección, por el mismo
+ * backend que Transport_I2C_Read
+ *
+ * @param i2c_addr : dirección del sensor
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_I2C_Write(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data)
+{
+    if (Get_Transport_Type() == TRANSPORT_I2C_IDF)
+    {
+        return I2C_IDF_Write_Addr(i2c_addr, reg_addr, data) == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+    }
+    return Write8_bit(i2c_addr, reg_addr, data) == I2C_SUCCESS ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+}
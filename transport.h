@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Arduino.h"
+#include "def.h"
+
+// Tamaño máximo de ráfaga i2c (buffer de TwoWire)
+#define I2C_MAX_BURST           128
+
+typedef enum
+{
+    TRANSPORT_I2C = 0,
+    TRANSPORT_SPI,
+    TRANSPORT_I2C_IDF // i2c sobre el driver i2c_master de ESP-IDF (i2c_idf.h)
+} TransportType_t;
+
+typedef enum
+{
+    TRANSPORT_FAILED = 0,
+    TRANSPORT_SUCCESS
+} TransportEnum_t;
+
+/*! Operaciones de un bus: todas las lecturas son en ráfaga desde reg_addr */
+struct Transport
+{
+    TransportEnum_t (*init)();
+    TransportEnum_t (*read)(uint8_t reg_addr, uint8_t *data, uint16_t len);
+    TransportEnum_t (*write)(uint8_t reg_addr, uint8_t data);
+    TransportEnum_t (*write_flag)(uint8_t reg_addr, uint8_t pos, uint8_t value);
+};
+
+/**
+ * @brief Selección e inicialización del bus
+ *
+ * @param type : i2c, spi o i2c de ESP-IDF
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Init_Transport(TransportType_t type);
+
+/**
+ * @brief Bus seleccionado actualmente
+ *
+ * @return TransportType_t
+ */
+TransportType_t Get_Transport_Type();
+
+/**
+ * @brief Lectura en ráfaga de registros consecutivos
+ *
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read(uint8_t reg_addr, uint8_t *data, uint16_t len);
+
+/**
+ * @brief Lectura de registros de 8 bits
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read8(uint8_t reg_addr, uint8_t *data);
+
+/**
+ * @brief Lectura de registros de 16 bits (little endian)
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read16(uint8_t reg_addr, uint16_t *data);
+
+/**
+ * @brief Lectura de registros de 24 bits (little endian)
+ *
+ * @param reg_addr : dirección de registro
+ * @param data : lectura
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Read24(uint8_t reg_addr, uint32_t *data);
+
+/*!
+ * @brief Escritura en registros de 8 bits
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] data : dato que escribimos en el registro
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Write(uint8_t reg_addr, uint8_t data);
+
+/*!
+ * @brief Escritura por bandera en registro
+ * @param[in] reg_addr : dirección de registro
+ * @param[in] pos : posición a cambiar
+ * @param[in] value : valor del bit
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_Write_Flag(uint8_t reg_addr, uint8_t pos, uint8_t value);
+
+/**
+ * @brief Lectura en ráfaga de un sensor i2c en otra dirección, con la misma división
+ * en trozos que el bus i2c seleccionado. Con TRANSPORT_I2C_IDF va por el backend de
+ * ESP-IDF; si no, por Wire (requiere Init_I2C)
+ *
+ * @param i2c_addr : dirección del sensor (ADDR_I2C o ADDR_I2C_ALT)
+ * @param reg_addr : dirección del primer registro
+ * @param data : buffer de salida
+ * @param len : número de bytes
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_I2C_Read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data, uint16_t len);
+
+/**
+ * @brief Escritura de un registro de un sensor i2c en otra dirección, por el mismo
+ * backend que Transport_I2C_Read
+ *
+ * @param i2c_addr : dirección del sensor
+ * @param reg_addr : dirección de registro
+ * @param data : dato
+ * @return TransportEnum_t error/success
+ */
+TransportEnum_t Transport_I2C_Write(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data);